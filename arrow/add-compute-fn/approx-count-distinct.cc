@@ -0,0 +1,273 @@
+// ------------------------------
+// Dependencies
+
+#include "approx-count-distinct.hpp"
+
+#include <cmath>
+
+
+// ------------------------------
+// Options
+
+const FunctionOptionsType*
+GetApproxCountDistinctOptionsType() {
+  static const RecipeOptionsType<ApproxCountDistinctOptions> options_type;
+  return &options_type;
+}
+
+ApproxCountDistinctOptions::ApproxCountDistinctOptions(int precision)
+  : FunctionOptions(GetApproxCountDistinctOptionsType())
+   ,precision(precision) {}
+
+string
+ApproxCountDistinctOptions::Describe() const {
+  return "ApproxCountDistinctOptions(precision=" + std::to_string(precision) + ")";
+}
+
+bool
+ApproxCountDistinctOptions::IsEqual(const ApproxCountDistinctOptions &other) const {
+  return precision == other.precision;
+}
+
+
+// ------------------------------
+// Structs and Classes
+
+// >> Documentation for a compute function
+const FunctionDoc approx_count_distinct_doc {
+   "Estimate the number of distinct non-null values"
+  ,(
+     "Values are hashed with Hashing64 into a HyperLogLog sketch, so memory use\n"
+     "depends on ApproxCountDistinctOptions::precision rather than on the number\n"
+     "of distinct values. Nulls are not counted."
+   )
+  ,{ "values" }
+  ,"ApproxCountDistinctOptions"
+};
+
+
+// >> Aggregate state
+/**
+ * A HyperLogLog sketch. The top `precision` bits of a value's 64-bit hash choose a
+ * register, and the register keeps the largest "rank" it has seen, where rank is 1 plus
+ * the number of leading zeros in the remaining bits.
+ *
+ * The compute framework creates one state for each thread that consumes input, then
+ * merges them before `Finalize`. Merging takes the max of each register, so the result
+ * doesn't depend on how the input was split.
+ */
+struct HyperLogLogState : public KernelState {
+  explicit HyperLogLogState(int precision)
+    : precision(precision), registers(int64_t{1} << precision, 0) {}
+
+  void
+  Add(uint64_t hash) {
+    uint64_t register_ndx = hash >> (64 - precision);
+    uint64_t rank_bits    = hash << precision;
+
+    // leading zeros can't count past the bits that remain after the register index
+    int rank = 64 - precision + 1;
+    if (rank_bits != 0) { rank = __builtin_clzll(rank_bits) + 1; }
+
+    registers[register_ndx] = std::max(registers[register_ndx], static_cast<uint8_t>(rank));
+  }
+
+  void
+  MergeFrom(const HyperLogLogState &other) {
+    for (size_t reg_ndx = 0; reg_ndx < registers.size(); ++reg_ndx) {
+      registers[reg_ndx] = std::max(registers[reg_ndx], other.registers[reg_ndx]);
+    }
+  }
+
+  /**
+   * The raw HyperLogLog estimate, with the linear counting correction for small
+   * cardinalities. 64-bit hashes make the large-range correction unnecessary.
+   */
+  int64_t
+  Estimate() const {
+    double register_count = static_cast<double>(registers.size());
+    double alpha          = 0.7213 / (1.0 + 1.079 / register_count);
+    switch (precision) {
+      case 4: alpha = 0.673; break;
+      case 5: alpha = 0.697; break;
+      case 6: alpha = 0.709; break;
+      default: break;
+    }
+
+    double  inverse_sum = 0;
+    int64_t empty_count = 0;
+    for (uint8_t rank : registers) {
+      inverse_sum += std::ldexp(1.0, -rank);
+      if (rank == 0) { ++empty_count; }
+    }
+
+    double estimate = alpha * register_count * register_count / inverse_sum;
+    if (estimate <= 2.5 * register_count and empty_count > 0) {
+      estimate = register_count * std::log(register_count / empty_count);
+    }
+
+    return std::llround(estimate);
+  }
+
+  int             precision;
+  vector<uint8_t> registers;
+};
+
+
+// >> Kernel implementations for a compute function
+struct ApproxCountDistinct {
+
+  static Result<std::unique_ptr<KernelState>>
+  Init(KernelContext*, const KernelInitArgs &args) {
+    if (args.options == nullptr) {
+      return Status::Invalid("Attempted to call a kernel without options");
+    }
+
+    const auto &options = static_cast<const ApproxCountDistinctOptions&>(*args.options);
+    if (options.precision < 4 or options.precision > 18) {
+      return Status::Invalid(
+        "approx_count_distinct precision must be in [4, 18], got ", options.precision
+      );
+    }
+
+    return std::make_unique<HyperLogLogState>(options.precision);
+  }
+
+  /**
+   * Hashes `values` one minibatch at a time with `Hashing64`, the same path that
+   * "hash_columns" uses for 64-bit hashes, and adds each valid row's hash to the sketch.
+   * The minibatch of hashes lives on the thread's hash stack, so consuming a batch doesn't
+   * allocate.
+   */
+  static Status
+  ConsumeArray(KernelContext *ctx, const ArraySpan &values, HyperLogLogState *state) {
+    ARROW_ASSIGN_OR_RAISE(
+       KeyColumnArray values_col
+      ,ColumnArrayFromArrayData(values.ToArrayData(), 0, values.length)
+    );
+
+    ARROW_ASSIGN_OR_RAISE(
+       TempVectorStack *stack_memallocator
+      ,ThreadLocalHashStack(hash64_stacksize + hashes_stacksize)
+    );
+
+    TempVectorHolder<uint64_t> hashes_holder(stack_memallocator, max_batchsize);
+    uint64_t *batch_hashes = hashes_holder.mutable_data();
+
+    LightContext hash_ctx;
+    hash_ctx.hardware_flags = ctx->exec_context()->cpu_info()->hardware_flags();
+    hash_ctx.stack          = stack_memallocator;
+
+    bool                   has_nulls = values.GetNullCount() > 0;
+    vector<KeyColumnArray> batch_cols(1);
+    for (int64_t batch_start = 0; batch_start < values.length; batch_start += max_batchsize) {
+      int64_t batch_len = std::min<int64_t>(max_batchsize, values.length - batch_start);
+
+      batch_cols[0] = values_col.Slice(batch_start, batch_len);
+      Hashing64::HashMultiColumn(batch_cols, &hash_ctx, batch_hashes);
+
+      for (int64_t row_ndx = 0; row_ndx < batch_len; ++row_ndx) {
+        if (has_nulls and not values.IsValid(batch_start + row_ndx)) { continue; }
+        state->Add(batch_hashes[row_ndx]);
+      }
+    }
+
+    return Status::OK();
+  }
+
+  static Status
+  Consume(KernelContext *ctx, const ExecSpan &input_args) {
+    RECIPE_TRACE_KERNEL("approx_count_distinct", input_args.length);
+    auto state = static_cast<HyperLogLogState*>(ctx->state());
+
+    if (input_args[0].is_array()) {
+      return ConsumeArray(ctx, input_args[0].array, state);
+    }
+
+    // A scalar is hashed the same way as an array of length 1
+    const auto &values_scalar = *input_args[0].scalar;
+    if (not values_scalar.is_valid) { return Status::OK(); }
+
+    ARROW_ASSIGN_OR_RAISE(
+       auto values_arr
+      ,arrow::MakeArrayFromScalar(values_scalar, 1, ctx->memory_pool())
+    );
+
+    return ConsumeArray(ctx, ArraySpan(*values_arr->data()), state);
+  }
+
+  static Status
+  Merge(KernelContext*, KernelState &&src, KernelState *dst) {
+    static_cast<HyperLogLogState*>(dst)->MergeFrom(static_cast<HyperLogLogState&>(src));
+    return Status::OK();
+  }
+
+  static Status
+  Finalize(KernelContext *ctx, Datum *out) {
+    auto state = static_cast<HyperLogLogState*>(ctx->state());
+
+    *out = Datum(state->Estimate());
+    return Status::OK();
+  }
+
+
+  static constexpr uint32_t max_batchsize    = MiniBatch::kMiniBatchLength;
+  static constexpr int64_t  hashes_stacksize = (
+    MiniBatch::kMiniBatchLength * sizeof(uint64_t) + 80
+  );
+};
+
+
+// ------------------------------
+// Functions
+
+// >> Function registration and kernel association
+/**
+ * An aggregate kernel is made of 4 functions, instead of a single `Exec`:
+ *  - `Init`    : creates a state (an empty sketch) for each thread that consumes input
+ *  - `Consume` : adds a batch of input to a thread's state
+ *  - `Merge`   : combines 2 states
+ *  - `Finalize`: produces the output from the merged state
+ */
+shared_ptr<ScalarAggregateFunction>
+RegisterApproxCountDistinctKernels() {
+  static const ApproxCountDistinctOptions default_options = (
+    ApproxCountDistinctOptions::Defaults()
+  );
+
+  auto fn_approx_count_distinct = std::make_shared<ScalarAggregateFunction>(
+     "approx_count_distinct"
+    ,Arity::Unary()
+    ,approx_count_distinct_doc
+    ,&default_options
+  );
+
+  ScalarAggregateKernel kernel {
+     { InputType::Any() }
+    ,OutputType(arrow::int64())
+    ,ApproxCountDistinct::Init
+    ,ApproxCountDistinct::Consume
+    ,ApproxCountDistinct::Merge
+    ,ApproxCountDistinct::Finalize
+  };
+
+  DCHECK_OK(fn_approx_count_distinct->AddKernel(std::move(kernel)));
+
+  return fn_approx_count_distinct;
+}
+
+
+void
+RegisterApproxCountDistinctFn(FunctionRegistry *registry) {
+  auto aggregate_fn = RegisterApproxCountDistinctKernels();
+  DCHECK_OK(registry->AddFunction(std::move(aggregate_fn)));
+}
+
+
+// >> Convenience functions
+Result<Datum>
+ApproxCountDistinct( const Datum                      &values
+                    ,const ApproxCountDistinctOptions &options
+                    ,ExecContext                      *ctx) {
+  return CallFunction("approx_count_distinct", { values }, &options, ctx);
+}
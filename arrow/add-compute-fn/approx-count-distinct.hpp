@@ -0,0 +1,55 @@
+#pragma once
+
+
+// ------------------------------
+// Dependencies
+
+#include "support.hpp"
+
+
+// ------------------------------
+// Classes
+
+// >> Options for a compute function
+/**
+ * Options for "approx_count_distinct". The function keeps a HyperLogLog sketch of
+ * 2^`precision` one-byte registers, so the default (12) uses 4 KiB per column and has a
+ * standard error of about 1.04 / sqrt(2^12), or 1.6%. Each extra bit of precision
+ * doubles the sketch and divides the error by sqrt(2). `precision` must be in [4, 18].
+ */
+class ARROW_EXPORT ApproxCountDistinctOptions : public FunctionOptions {
+  public:
+    explicit ApproxCountDistinctOptions(int precision = 12);
+
+    static constexpr char kTypeName[] = "ApproxCountDistinctOptions";
+    static ApproxCountDistinctOptions Defaults() { return ApproxCountDistinctOptions(); }
+
+    string Describe()                                        const;
+    bool   IsEqual(const ApproxCountDistinctOptions &other) const;
+
+    int precision;
+};
+
+
+// ------------------------------
+// Functions
+
+// >> Function registration and kernel association
+/**
+ * Registers "approx_count_distinct", an aggregate function that estimates the number of
+ * distinct non-null values in its argument.
+ */
+ARROW_EXPORT
+void
+RegisterApproxCountDistinctFn(FunctionRegistry *registry);
+
+
+// >> Convenience functions
+/** Invokes "approx_count_distinct" on `values`, which returns an int64 scalar. */
+ARROW_EXPORT
+Result<Datum>
+ApproxCountDistinct( const Datum                      &values
+                    ,const ApproxCountDistinctOptions &options = (
+                       ApproxCountDistinctOptions::Defaults()
+                     )
+                    ,ExecContext                      *ctx     = NULLPTR);
@@ -0,0 +1,343 @@
+// ------------------------------
+// Dependencies
+
+#include "recipe.hpp"
+#include "example.hpp"
+#include "executor.hpp"
+
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <arrow/util/byte_size.h>
+
+
+// ------------------------------
+// Macros and aliases
+
+using arrow::ChunkedArray;
+
+using std::chrono::steady_clock;
+
+
+// ------------------------------
+// Structs and Classes
+
+/** Settings for a sweep, from the command line. */
+struct BenchConfig {
+  int64_t max_length  { 100000000 };
+  double  min_seconds { 0.2 };
+  int     min_iters   { 3 };
+};
+
+/**
+ * One measurement: a function, called on one input, enough times to be stable. `mode` is
+ * how it was called: "call_function" (by name), "resolved" (through a `ResolvedKernel`)
+ * or "chunk_parallel" (through `CallFunctionChunkParallel`).
+ */
+struct BenchResult {
+  string  mode;
+  string  func_name;
+  string  type_name;
+  int64_t length;
+  double  null_fraction;
+  int     chunk_count;
+  int64_t input_bytes;
+  int     iterations;
+  double  best_ns;
+  double  mean_ns;
+
+  string
+  ToJson() const {
+    double best_seconds = best_ns / 1e9;
+
+    std::ostringstream json_stream;
+    json_stream << "{"
+                <<   "\"mode\": \""            << mode      << "\""
+                << ", \"function\": \""        << func_name << "\""
+                << ", \"type\": \""            << type_name << "\""
+                << ", \"length\": "            << length
+                << ", \"null_fraction\": "     << null_fraction
+                << ", \"chunks\": "            << chunk_count
+                << ", \"iterations\": "        << iterations
+                << ", \"ns_per_row\": "        << best_ns / length
+                << ", \"mean_ns_per_row\": "   << mean_ns / length
+                << ", \"rows_per_s\": "        << length / best_seconds
+                << ", \"bytes_per_s\": "       << input_bytes / best_seconds
+                << "}"
+    ;
+
+    return json_stream.str();
+  }
+};
+
+
+// ------------------------------
+// Functions
+
+// >> input data
+/**
+ * Builds `length` random values of `ArrowType`, where each value is null with probability
+ * `null_fraction`. Signed values are centered on 0, so absolute value takes both branches.
+ */
+template <typename ArrowType>
+Result<shared_ptr<Array>>
+BuildRandomArray(int64_t length, double null_fraction) {
+  using CType    = typename ArrowType::c_type;
+  using DistType = std::conditional_t<
+     std::is_floating_point<CType>::value
+    ,std::uniform_real_distribution<CType>
+    ,std::uniform_int_distribution<CType>
+  >;
+
+  CType max_val = std::is_floating_point<CType>::value ? CType(1e6) : CType(1 << 30);
+
+  std::mt19937_64             rng       { 42 };
+  DistType                    val_dist  { -max_val, max_val };
+  std::bernoulli_distribution null_dist { null_fraction };
+
+  arrow::NumericBuilder<ArrowType> builder;
+  ARROW_RETURN_NOT_OK(builder.Reserve(length));
+  for (int64_t ndx = 0; ndx < length; ++ndx) {
+    if (null_fraction > 0 and null_dist(rng)) { builder.UnsafeAppendNull(); }
+    else                                      { builder.UnsafeAppend(val_dist(rng)); }
+  }
+
+  return builder.Finish();
+}
+
+/** Builds `length` random strings of 4 to 32 characters, with nulls as above. */
+Result<shared_ptr<Array>>
+BuildRandomStrings(int64_t length, double null_fraction) {
+  std::mt19937_64                 rng       { 42 };
+  std::uniform_int_distribution<> len_dist  { 4, 32 };
+  std::uniform_int_distribution<> char_dist { 'a', 'z' };
+  std::bernoulli_distribution     null_dist { null_fraction };
+
+  arrow::StringBuilder builder;
+  ARROW_RETURN_NOT_OK(builder.Reserve(length));
+  ARROW_RETURN_NOT_OK(builder.ReserveData(length * 18));
+
+  string str_val;
+  for (int64_t ndx = 0; ndx < length; ++ndx) {
+    if (null_fraction > 0 and null_dist(rng)) {
+      ARROW_RETURN_NOT_OK(builder.AppendNull());
+      continue;
+    }
+
+    str_val.resize(len_dist(rng));
+    for (auto &str_char : str_val) { str_char = static_cast<char>(char_dist(rng)); }
+    ARROW_RETURN_NOT_OK(builder.Append(str_val));
+  }
+
+  return builder.Finish();
+}
+
+Result<shared_ptr<Array>>
+BuildInput(const string &type_name, int64_t length, double null_fraction) {
+  if (type_name == "int32")  { return BuildRandomArray<arrow::Int32Type> (length, null_fraction); }
+  if (type_name == "int64")  { return BuildRandomArray<arrow::Int64Type> (length, null_fraction); }
+  if (type_name == "double") { return BuildRandomArray<arrow::DoubleType>(length, null_fraction); }
+  if (type_name == "utf8")   { return BuildRandomStrings(length, null_fraction); }
+
+  return Status::Invalid("No input generator for type: ", type_name);
+}
+
+/** Splits `input_arr` into `chunk_count` zero-copy slices of (nearly) equal length. */
+Result<shared_ptr<ChunkedArray>>
+SplitIntoChunks(const shared_ptr<Array> &input_arr, int chunk_count) {
+  arrow::ArrayVector chunks;
+  int64_t            chunk_len = (input_arr->length() + chunk_count - 1) / chunk_count;
+
+  for (int64_t chunk_start = 0; chunk_start < input_arr->length(); chunk_start += chunk_len) {
+    chunks.push_back(input_arr->Slice(chunk_start, chunk_len));
+  }
+
+  return ChunkedArray::Make(std::move(chunks), input_arr->type());
+}
+
+
+// >> measurement
+/**
+ * Calls `call_fn` once to warm up, then repeatedly until both `min_iters` calls and
+ * `min_seconds` have elapsed. The best call is reported as the throughput; the mean is
+ * also reported, to show noise.
+ */
+template <typename CallFn>
+Result<BenchResult>
+RunBenchmark( const BenchConfig                &config
+             ,const string                     &mode
+             ,const string                     &func_name
+             ,const string                     &type_name
+             ,double                            null_fraction
+             ,const shared_ptr<ChunkedArray>   &input_chunks
+             ,CallFn                          &&call_fn) {
+  ARROW_RETURN_NOT_OK(call_fn());
+
+  double best_ns  = std::numeric_limits<double>::max();
+  double total_ns = 0;
+  int    iters    = 0;
+  while (iters < config.min_iters or total_ns < config.min_seconds * 1e9) {
+    auto tstart = steady_clock::now();
+    ARROW_RETURN_NOT_OK(call_fn());
+    auto tstop  = steady_clock::now();
+
+    std::chrono::duration<double, std::nano> elapsed = tstop - tstart;
+    best_ns   = std::min(best_ns, elapsed.count());
+    total_ns += elapsed.count();
+    ++iters;
+  }
+
+  return BenchResult {
+     mode
+    ,func_name
+    ,type_name
+    ,input_chunks->length()
+    ,null_fraction
+    ,input_chunks->num_chunks()
+    ,arrow::util::TotalBufferSize(*input_chunks)
+    ,iters
+    ,best_ns
+    ,total_ns / iters
+  };
+}
+
+/**
+ * Sweeps every (type, length, null fraction, chunk count) for the functions that accept
+ * that type, printing one JSON object per line as each measurement finishes. Arrow's
+ * built-in "abs" and "abs_checked" are measured alongside the recipe kernels. Chunked
+ * inputs are also measured with `CallFunctionChunkParallel` ("chunk_parallel" mode).
+ */
+Status
+RunSweep(const BenchConfig &config) {
+  vector<std::pair<string, vector<string>>> funcs_by_type {
+     { "int32" , { "named_scalar_fn", "absolute_value", "absolute_value_checked"
+                  ,"abs", "abs_checked" } }
+    ,{ "int64" , { "named_scalar_fn", "absolute_value", "absolute_value_checked"
+                  ,"abs", "abs_checked" } }
+    ,{ "double", { "named_scalar_fn", "absolute_value", "absolute_value_checked"
+                  ,"abs", "abs_checked" } }
+    ,{ "utf8"  , { "named_scalar_fn" } }
+  };
+
+  vector<double> null_fractions { 0.0, 0.1, 0.5 };
+  vector<int>    chunk_counts   { 1, 16 };
+
+  for (const auto &type_funcs : funcs_by_type) {
+    for (int64_t length = 1000; length <= config.max_length; length *= 10) {
+      for (double null_fraction : null_fractions) {
+        ARROW_ASSIGN_OR_RAISE(
+           auto input_arr
+          ,BuildInput(type_funcs.first, length, null_fraction)
+        );
+
+        for (int chunk_count : chunk_counts) {
+          ARROW_ASSIGN_OR_RAISE(auto input_chunks, SplitIntoChunks(input_arr, chunk_count));
+
+          for (const auto &func_name : type_funcs.second) {
+            Datum input_arg { input_chunks };
+
+            ARROW_ASSIGN_OR_RAISE(
+               auto result
+              ,RunBenchmark(
+                  config, "call_function", func_name, type_funcs.first, null_fraction
+                 ,input_chunks
+                 ,[&]() { return CallFunction(func_name, { input_arg }).status(); }
+               )
+            );
+
+            std::cout << result.ToJson() << std::endl;
+
+            if (chunk_count == 1) { continue; }
+            ARROW_ASSIGN_OR_RAISE(
+               auto parallel_result
+              ,RunBenchmark(
+                  config, "chunk_parallel", func_name, type_funcs.first, null_fraction
+                 ,input_chunks
+                 ,[&]() { return CallFunctionChunkParallel(func_name, input_arg).status(); }
+               )
+            );
+
+            std::cout << parallel_result.ToJson() << std::endl;
+          }
+        }
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+/**
+ * Compares calling a function by name with calling a `ResolvedKernel`, on small batches
+ * (where the per-call overhead of `CallFunction` is most of the cost). Each measurement
+ * is one call on one batch.
+ */
+Status
+RunSmallBatchSweep(const BenchConfig &config) {
+  vector<string>  func_names    { "named_scalar_fn", "absolute_value" };
+  vector<int64_t> batch_lengths { 64, 1024 };
+
+  for (int64_t batch_len : batch_lengths) {
+    ARROW_ASSIGN_OR_RAISE(auto input_arr   , BuildInput("int32", batch_len, 0.1));
+    ARROW_ASSIGN_OR_RAISE(auto input_chunks, SplitIntoChunks(input_arr, 1));
+
+    Datum input_arg { input_arr };
+    for (const auto &func_name : func_names) {
+      ARROW_ASSIGN_OR_RAISE(
+         auto named_result
+        ,RunBenchmark(
+            config, "call_function", func_name, "int32", 0.1, input_chunks
+           ,[&]() { return CallFunction(func_name, { input_arg }).status(); }
+         )
+      );
+
+      ARROW_ASSIGN_OR_RAISE(
+         auto resolved_kernel
+        ,ResolvedKernel::Make(func_name, { arrow::int32() })
+      );
+      ARROW_ASSIGN_OR_RAISE(
+         auto resolved_result
+        ,RunBenchmark(
+            config, "resolved", func_name, "int32", 0.1, input_chunks
+           ,[&]() { return resolved_kernel->Call({ input_arg }).status(); }
+         )
+      );
+
+      std::cout << named_result.ToJson()    << std::endl;
+      std::cout << resolved_result.ToJson() << std::endl;
+    }
+  }
+
+  return Status::OK();
+}
+
+
+/**
+ * Usage: bench [max_length] [min_seconds]
+ *
+ * Output is JSON lines (one object per measurement) on stdout, so it can be diffed
+ * between builds or loaded with e.g. `pandas.read_json(path, lines=True)`.
+ */
+int main(int argc, char **argv) {
+  BenchConfig config;
+  if (argc > 1) { config.max_length  = std::stoll(argv[1]); }
+  if (argc > 2) { config.min_seconds = std::stod (argv[2]); }
+
+  // >> Register the recipe functions next to the built-in functions
+  auto fn_registry = arrow::compute::GetFunctionRegistry();
+  RegisterNamedScalarFn(fn_registry);
+  RegisterAbsoluteValueFunctions(fn_registry);
+
+  // >> With `-Dkernel_tracing=true`, per-kernel counters are written to stderr at exit
+  DumpKernelCountersAtExit();
+
+  auto sweep_status = RunSmallBatchSweep(config);
+  if (sweep_status.ok()) { sweep_status = RunSweep(config); }
+
+  if (not sweep_status.ok()) {
+    std::cerr << sweep_status.message() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
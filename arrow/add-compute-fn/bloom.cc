@@ -0,0 +1,496 @@
+// ------------------------------
+// Dependencies
+
+#include "bloom.hpp"
+
+#include <cstring>
+#include <string_view>
+
+#if RECIPE_X86_SIMD
+  #include <immintrin.h>
+#endif
+
+
+// ------------------------------
+// Options
+
+const FunctionOptionsType*
+GetBloomFilterOptionsType() {
+  static const RecipeOptionsType<BloomFilterOptions> options_type;
+  return &options_type;
+}
+
+BloomFilterOptions::BloomFilterOptions(int bits_per_key)
+  : FunctionOptions(GetBloomFilterOptionsType())
+   ,bits_per_key(bits_per_key) {}
+
+string
+BloomFilterOptions::Describe() const {
+  return "BloomFilterOptions(bits_per_key=" + std::to_string(bits_per_key) + ")";
+}
+
+bool
+BloomFilterOptions::IsEqual(const BloomFilterOptions &other) const {
+  return bits_per_key == other.bits_per_key;
+}
+
+
+// ------------------------------
+// Structs and Classes
+
+// >> Documentation for compute functions
+const FunctionDoc bloom_build_doc {
+   "Build a blocked Bloom filter from the hashes of non-null keys"
+  ,(
+     "Keys are hashed with Hashing32 (the same hashes as 'named_scalar_fn'). The\n"
+     "filter is returned as a binary scalar, for use with 'bloom_probe'."
+   )
+  ,{ "keys" }
+  ,"BloomFilterOptions"
+};
+
+const FunctionDoc bloom_probe_doc {
+   "Test whether each value may be in a Bloom filter from 'bloom_build'"
+  ,(
+     "Outputs true if a value may be one of the filter's keys, and false if it\n"
+     "definitely isn't. Null values produce null.\n"
+     "'values' must be an array; 'filter' must not be null."
+   )
+  ,{ "values", "filter" }
+};
+
+
+// >> Filter layout
+/**
+ * A split-block Bloom filter: an array of 256-bit blocks, each made of 8 uint32 words.
+ * A hash selects one block, then sets (or tests) one bit in each of the block's words,
+ * using a different odd multiplier ("salt") per word. A lookup touches one cache line and
+ * the 8 word tests are independent, so a probe is a single 256-bit AND-compare.
+ *
+ * This is the layout of Parquet's bloom filters, with a 32-bit hash in place of a 64-bit
+ * one: the block comes from the hash's high bits (by multiply-shift), and each word's bit
+ * comes from the top 5 bits of the hash times that word's salt.
+ */
+constexpr int      bloom_block_words = 8;
+constexpr int64_t  bloom_block_bytes = bloom_block_words * sizeof(uint32_t);
+
+alignas(32) constexpr uint32_t bloom_salts[bloom_block_words] {
+   0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU
+  ,0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+};
+
+inline int64_t
+BloomBlockIndex(uint32_t hash, int64_t num_blocks) {
+  return static_cast<int64_t>((static_cast<uint64_t>(hash) * num_blocks) >> 32);
+}
+
+inline void
+BloomInsert(uint32_t *filter_words, int64_t num_blocks, uint32_t hash) {
+  uint32_t *block = filter_words + BloomBlockIndex(hash, num_blocks) * bloom_block_words;
+
+  for (int word_ndx = 0; word_ndx < bloom_block_words; ++word_ndx) {
+    block[word_ndx] |= uint32_t{1} << ((hash * bloom_salts[word_ndx]) >> 27);
+  }
+}
+
+
+// >> Probe loops
+/**
+ * A loop that probes `filter_words` for each of `n` hashes, writing 1 to `found` if the
+ * hash may be present and 0 otherwise.
+ */
+using BloomProbeLoop = void (*)( const uint32_t *filter_words
+                                ,int64_t         num_blocks
+                                ,const uint32_t *hashes
+                                ,int64_t         n
+                                ,uint8_t        *found);
+
+void
+BloomProbeScalar( const uint32_t *filter_words
+                 ,int64_t         num_blocks
+                 ,const uint32_t *hashes
+                 ,int64_t         n
+                 ,uint8_t        *found) {
+  for (int64_t ndx = 0; ndx < n; ++ndx) {
+    uint32_t        hash      = hashes[ndx];
+    int64_t         block_ndx = BloomBlockIndex(hash, num_blocks);
+    const uint32_t *block     = filter_words + block_ndx * bloom_block_words;
+
+    // Written without early exit, so that compilers can vectorize the 8 word tests
+    uint32_t missing_bits = 0;
+    for (int word_ndx = 0; word_ndx < bloom_block_words; ++word_ndx) {
+      uint32_t word_mask = uint32_t{1} << ((hash * bloom_salts[word_ndx]) >> 27);
+      missing_bits |= word_mask & ~block[word_ndx];
+    }
+
+    found[ndx] = (missing_bits == 0);
+  }
+}
+
+#if RECIPE_X86_SIMD
+
+/**
+ * Computes all 8 word masks with one multiply, shift and variable shift, then tests them
+ * against the block with `vptest`: the carry flag is set if every mask bit is set in the
+ * block.
+ */
+__attribute__((target("avx2")))
+void
+BloomProbeAvx2( const uint32_t *filter_words
+               ,int64_t         num_blocks
+               ,const uint32_t *hashes
+               ,int64_t         n
+               ,uint8_t        *found) {
+  const __m256i salts = _mm256_load_si256(reinterpret_cast<const __m256i*>(bloom_salts));
+  const __m256i ones  = _mm256_set1_epi32(1);
+
+  for (int64_t ndx = 0; ndx < n; ++ndx) {
+    uint32_t hash      = hashes[ndx];
+    int64_t  block_ndx = BloomBlockIndex(hash, num_blocks);
+
+    __m256i bit_ndx = _mm256_srli_epi32(
+      _mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(hash)), salts), 27
+    );
+    __m256i mask    = _mm256_sllv_epi32(ones, bit_ndx);
+    __m256i block   = _mm256_loadu_si256(
+      reinterpret_cast<const __m256i*>(filter_words + block_ndx * bloom_block_words)
+    );
+
+    found[ndx] = static_cast<uint8_t>(_mm256_testc_si256(block, mask));
+  }
+}
+
+#endif
+
+/** Returns the widest probe loop for `level`. AVX-512 has nothing to add per block. */
+BloomProbeLoop
+SelectBloomProbeLoop(SimdLevel level) {
+#if RECIPE_X86_SIMD
+  if (level == SimdLevel::AVX2 or level == SimdLevel::AVX512) { return BloomProbeAvx2; }
+#endif
+
+  return BloomProbeScalar;
+}
+
+struct BloomProbeLoopData : public KernelState {
+  explicit BloomProbeLoopData(BloomProbeLoop loop) : loop(loop) {}
+
+  BloomProbeLoop loop;
+};
+
+
+// >> Shared hashing
+/**
+ * Hashes `values` one minibatch at a time with `Hashing32` and passes each minibatch of
+ * hashes to `consume_fn(batch_start, batch_len, batch_hashes)`. Both functions below use
+ * this, so keys and probed values are hashed identically.
+ */
+template <typename ConsumeFn>
+Status
+VisitHashBatches(KernelContext *ctx, const ArraySpan &values, ConsumeFn &&consume_fn) {
+  static constexpr uint32_t max_batchsize    = MiniBatch::kMiniBatchLength;
+  static constexpr int64_t  hashes_stacksize = max_batchsize * sizeof(uint32_t) + 80;
+
+  ARROW_ASSIGN_OR_RAISE(
+     KeyColumnArray values_col
+    ,ColumnArrayFromArrayData(values.ToArrayData(), 0, values.length)
+  );
+
+  ARROW_ASSIGN_OR_RAISE(
+     TempVectorStack *stack_memallocator
+    ,ThreadLocalHashStack(hash32_stacksize + hashes_stacksize)
+  );
+
+  TempVectorHolder<uint32_t> hashes_holder(stack_memallocator, max_batchsize);
+  uint32_t *batch_hashes = hashes_holder.mutable_data();
+
+  LightContext hash_ctx;
+  hash_ctx.hardware_flags = ctx->exec_context()->cpu_info()->hardware_flags();
+  hash_ctx.stack          = stack_memallocator;
+
+  vector<KeyColumnArray> batch_cols(1);
+  for (int64_t batch_start = 0; batch_start < values.length; batch_start += max_batchsize) {
+    int64_t batch_len = std::min<int64_t>(max_batchsize, values.length - batch_start);
+
+    batch_cols[0] = values_col.Slice(batch_start, batch_len);
+    Hashing32::HashMultiColumn(batch_cols, &hash_ctx, batch_hashes);
+
+    ARROW_RETURN_NOT_OK(consume_fn(batch_start, batch_len, batch_hashes));
+  }
+
+  return Status::OK();
+}
+
+
+// >> Kernel implementations for "bloom_build"
+/**
+ * The filter's size depends on how many keys there are, which isn't known until every
+ * batch has been consumed. So each thread's state collects the hashes of its keys (4
+ * bytes per key, the same order of size as the filter), and the filter is built from the
+ * merged hashes in `Finalize`.
+ */
+struct BloomBuildState : public KernelState {
+  explicit BloomBuildState(int bits_per_key) : bits_per_key(bits_per_key) {}
+
+  int              bits_per_key;
+  vector<uint32_t> key_hashes;
+};
+
+struct BloomBuild {
+
+  static Result<std::unique_ptr<KernelState>>
+  Init(KernelContext*, const KernelInitArgs &args) {
+    if (args.options == nullptr) {
+      return Status::Invalid("Attempted to call a kernel without options");
+    }
+
+    const auto &options = static_cast<const BloomFilterOptions&>(*args.options);
+    if (options.bits_per_key <= 0) {
+      return Status::Invalid("bloom_build bits_per_key must be positive");
+    }
+
+    return std::make_unique<BloomBuildState>(options.bits_per_key);
+  }
+
+  static Status
+  Consume(KernelContext *ctx, const ExecSpan &input_args) {
+    RECIPE_TRACE_KERNEL("bloom_build", input_args.length);
+    if (not input_args[0].is_array()) {
+      return Status::Invalid("bloom_build expects an array of keys");
+    }
+
+    auto             state     = static_cast<BloomBuildState*>(ctx->state());
+    const ArraySpan &keys      = input_args[0].array;
+    bool             has_nulls = keys.GetNullCount() > 0;
+
+    return VisitHashBatches(
+       ctx
+      ,keys
+      ,[&](int64_t batch_start, int64_t batch_len, const uint32_t *batch_hashes) {
+         for (int64_t row_ndx = 0; row_ndx < batch_len; ++row_ndx) {
+           if (has_nulls and not keys.IsValid(batch_start + row_ndx)) { continue; }
+           state->key_hashes.push_back(batch_hashes[row_ndx]);
+         }
+
+         return Status::OK();
+       }
+    );
+  }
+
+  static Status
+  Merge(KernelContext*, KernelState &&src, KernelState *dst) {
+    auto &src_hashes = static_cast<BloomBuildState&>(src).key_hashes;
+    auto &dst_hashes = static_cast<BloomBuildState*>(dst)->key_hashes;
+
+    dst_hashes.insert(dst_hashes.end(), src_hashes.begin(), src_hashes.end());
+    return Status::OK();
+  }
+
+  static Status
+  Finalize(KernelContext *ctx, Datum *out) {
+    auto state = static_cast<BloomBuildState*>(ctx->state());
+
+    // Duplicate keys are counted, which only makes the filter larger than it needs to be
+    int64_t key_count  = static_cast<int64_t>(state->key_hashes.size());
+    int64_t num_blocks = std::max<int64_t>(
+       1
+      ,(key_count * state->bits_per_key + bloom_block_bytes * 8 - 1) / (bloom_block_bytes * 8)
+    );
+
+    ARROW_ASSIGN_OR_RAISE(auto filter_buffer, ctx->Allocate(num_blocks * bloom_block_bytes));
+    std::memset(filter_buffer->mutable_data(), 0, filter_buffer->size());
+
+    auto filter_words = reinterpret_cast<uint32_t*>(filter_buffer->mutable_data());
+    for (uint32_t key_hash : state->key_hashes) {
+      BloomInsert(filter_words, num_blocks, key_hash);
+    }
+
+    *out = Datum(std::make_shared<arrow::BinaryScalar>(std::move(filter_buffer)));
+    return Status::OK();
+  }
+};
+
+
+// >> Kernel implementations for "bloom_probe"
+struct BloomProbe {
+
+  /**
+   * The filter's bytes, from a binary scalar or from the one-row array the executor makes
+   * of it when the values are an array too. Null filters are rejected, since they would
+   * otherwise be read through a null `value`.
+   */
+  static Result<std::string_view>
+  FilterBytes(const ExecValue &filter_arg) {
+    if (filter_arg.is_scalar()) {
+      const auto &filter_scalar = static_cast<const arrow::BaseBinaryScalar&>(
+        *filter_arg.scalar
+      );
+
+      if (not filter_scalar.is_valid) {
+        return Status::Invalid("bloom_probe filter must not be null");
+      }
+
+      return std::string_view {
+         reinterpret_cast<const char*>(filter_scalar.value->data())
+        ,static_cast<size_t>(filter_scalar.value->size())
+      };
+    }
+
+    const ArraySpan &filter_arr = filter_arg.array;
+    if (filter_arr.length != 1) {
+      return Status::Invalid("bloom_probe expects a single filter, got ", filter_arr.length);
+    }
+
+    if (filter_arr.IsNull(0)) {
+      return Status::Invalid("bloom_probe filter must not be null");
+    }
+
+    const int32_t *filter_offsets = filter_arr.GetValues<int32_t>(1);
+    return std::string_view {
+       reinterpret_cast<const char*>(filter_arr.buffers[2].data) + filter_offsets[0]
+      ,static_cast<size_t>(filter_offsets[1] - filter_offsets[0])
+    };
+  }
+
+  /**
+   * Probes one minibatch at a time: the minibatch's hashes and probe results are on the
+   * thread's hash stack, and results are packed into the preallocated output bitmap.
+   */
+  static Status
+  Exec(KernelContext *ctx, const ExecSpan &input_args, ExecResult *out) {
+    RECIPE_TRACE_KERNEL("bloom_probe", input_args.length);
+    if (not input_args[0].is_array()) {
+      return Status::Invalid("bloom_probe expects an array of values, got a scalar");
+    }
+
+    // >> Validate the filter
+    ARROW_ASSIGN_OR_RAISE(auto filter_bytes, FilterBytes(input_args[1]));
+
+    int64_t filter_size = static_cast<int64_t>(filter_bytes.size());
+    if (filter_size == 0 or filter_size % bloom_block_bytes != 0) {
+      return Status::Invalid("bloom_probe filter must be a whole number of blocks");
+    }
+
+    auto    filter_words = reinterpret_cast<const uint32_t*>(filter_bytes.data());
+    int64_t num_blocks   = filter_size / bloom_block_bytes;
+
+    // >> Probe each minibatch of hashes
+    auto probe_loop = static_cast<const BloomProbeLoopData*>(ctx->kernel()->data.get())->loop;
+
+    ArraySpan *out_arr  = out->array_span();
+    uint8_t   *out_bits = out_arr->buffers[1].data;
+
+    ARROW_ASSIGN_OR_RAISE(
+       TempVectorStack *stack_memallocator
+      ,ThreadLocalHashStack(hash32_stacksize + found_stacksize + hashes_stacksize)
+    );
+
+    TempVectorHolder<uint8_t> found_holder(stack_memallocator, max_batchsize);
+    uint8_t *batch_found = found_holder.mutable_data();
+
+    return VisitHashBatches(
+       ctx
+      ,input_args[0].array
+      ,[&](int64_t batch_start, int64_t batch_len, const uint32_t *batch_hashes) {
+         probe_loop(filter_words, num_blocks, batch_hashes, batch_len, batch_found);
+
+         for (int64_t row_ndx = 0; row_ndx < batch_len; ++row_ndx) {
+           arrow::bit_util::SetBitTo(
+              out_bits
+             ,out_arr->offset + batch_start + row_ndx
+             ,batch_found[row_ndx] != 0
+           );
+         }
+
+         return Status::OK();
+       }
+    );
+  }
+
+
+  static constexpr uint32_t max_batchsize    = MiniBatch::kMiniBatchLength;
+  static constexpr int64_t  found_stacksize  = max_batchsize * sizeof(uint8_t)  + 80;
+  static constexpr int64_t  hashes_stacksize = max_batchsize * sizeof(uint32_t) + 80;
+};
+
+
+// ------------------------------
+// Functions
+
+// >> Function registration and kernel association
+shared_ptr<ScalarAggregateFunction>
+RegisterBloomBuildKernels() {
+  static const BloomFilterOptions default_options = BloomFilterOptions::Defaults();
+
+  auto fn_bloom_build = std::make_shared<ScalarAggregateFunction>(
+     "bloom_build"
+    ,Arity::Unary()
+    ,bloom_build_doc
+    ,&default_options
+  );
+
+  ScalarAggregateKernel kernel {
+     { InputType::Any() }
+    ,OutputType(arrow::binary())
+    ,BloomBuild::Init
+    ,BloomBuild::Consume
+    ,BloomBuild::Merge
+    ,BloomBuild::Finalize
+  };
+
+  DCHECK_OK(fn_bloom_build->AddKernel(std::move(kernel)));
+
+  return fn_bloom_build;
+}
+
+/**
+ * The probe loop is chosen once, for the CPU we're running on, and stored in the kernel's
+ * `data` (as the absolute value kernels do).
+ */
+shared_ptr<ScalarFunction>
+RegisterBloomProbeKernels() {
+  auto fn_bloom_probe = std::make_shared<ScalarFunction>(
+     "bloom_probe"
+    ,Arity::Binary()
+    ,bloom_probe_doc
+  );
+
+  auto hardware_flags = default_exec_context()->cpu_info()->hardware_flags();
+
+  ScalarKernel kernel {
+     { InputType::Any(), InputType(arrow::binary()) }
+    ,OutputType(arrow::boolean())
+    ,BloomProbe::Exec
+  };
+
+  kernel.data = std::make_shared<BloomProbeLoopData>(
+    SelectBloomProbeLoop(SimdLevelFromFlags(hardware_flags))
+  );
+  DCHECK_OK(fn_bloom_probe->AddKernel(std::move(kernel)));
+
+  return fn_bloom_probe;
+}
+
+
+void
+RegisterBloomFilterFns(FunctionRegistry *registry) {
+  auto build_fn = RegisterBloomBuildKernels();
+  DCHECK_OK(registry->AddFunction(std::move(build_fn)));
+
+  auto probe_fn = RegisterBloomProbeKernels();
+  DCHECK_OK(registry->AddFunction(std::move(probe_fn)));
+}
+
+
+// >> Convenience functions
+Result<Datum>
+BloomBuild( const Datum              &keys
+           ,const BloomFilterOptions &options
+           ,ExecContext              *ctx) {
+  return CallFunction("bloom_build", { keys }, &options, ctx);
+}
+
+Result<Datum>
+BloomProbe(const Datum &values, const Datum &filter, ExecContext *ctx) {
+  return CallFunction("bloom_probe", { values, filter }, ctx);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+
+// ------------------------------
+// Dependencies
+
+#include "support.hpp"
+#include "simd-kernels.hpp"
+
+
+// ------------------------------
+// Classes
+
+// >> Options for a compute function
+/**
+ * Options for "bloom_build". The filter is sized for `bits_per_key` bits per input row,
+ * rounded up to whole 256-bit blocks. At the default (10), about 1% of absent keys are
+ * reported as present; each extra 5 bits per key cuts that by roughly 10x.
+ */
+class ARROW_EXPORT BloomFilterOptions : public FunctionOptions {
+  public:
+    explicit BloomFilterOptions(int bits_per_key = 10);
+
+    static constexpr char kTypeName[] = "BloomFilterOptions";
+    static BloomFilterOptions Defaults() { return BloomFilterOptions(); }
+
+    string Describe()                                const;
+    bool   IsEqual(const BloomFilterOptions &other) const;
+
+    int bits_per_key;
+};
+
+
+// ------------------------------
+// Functions
+
+// >> Function registration and kernel association
+/**
+ * Registers 2 functions that share a filter format:
+ *  - "bloom_build": an aggregate that builds a blocked Bloom filter from the `Hashing32`
+ *    hashes of its non-null keys, and outputs it as a binary scalar
+ *  - "bloom_probe": a scalar function of (values, filter) that outputs true where a value
+ *    may be in the filter, and false where it definitely isn't
+ *
+ * Keys and probed values must have the same type, because `Hashing32` hashes equal values
+ * of different types (e.g. int32 and int64) differently.
+ */
+ARROW_EXPORT
+void
+RegisterBloomFilterFns(FunctionRegistry *registry);
+
+
+// >> Convenience functions
+/** Invokes "bloom_build" on `keys`, which returns a binary scalar. */
+ARROW_EXPORT
+Result<Datum>
+BloomBuild( const Datum              &keys
+           ,const BloomFilterOptions &options = BloomFilterOptions::Defaults()
+           ,ExecContext              *ctx     = NULLPTR);
+
+/** Invokes "bloom_probe" on `values`, with a `filter` from `BloomBuild`. */
+ARROW_EXPORT
+Result<Datum>
+BloomProbe(const Datum &values, const Datum &filter, ExecContext *ctx = NULLPTR);
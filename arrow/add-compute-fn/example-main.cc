@@ -0,0 +1,309 @@
+// ------------------------------
+// Dependencies
+
+#include "recipe.hpp"
+#include "example.hpp"
+#include "fusion.hpp"
+
+#include <chrono>
+#include <random>
+
+
+// ------------------------------
+// Macros and aliases
+
+using arrow::Int32Type;
+using arrow::Int64Type;
+using arrow::DoubleType;
+using arrow::NumericBuilder;
+
+using std::chrono::steady_clock;
+
+
+// ------------------------------
+// Functions
+
+/** Builds an array of `length` values, uniformly distributed in [-max_val, max_val]. */
+template <typename ArrowType>
+Result<shared_ptr<Array>>
+BuildRandomArray(int64_t length, typename ArrowType::c_type max_val) {
+  using CType = typename ArrowType::c_type;
+  using DistType = std::conditional_t<
+     std::is_floating_point<CType>::value
+    ,std::uniform_real_distribution<CType>
+    ,std::uniform_int_distribution<CType>
+  >;
+
+  std::mt19937_64 rng { 42 };
+  DistType        dist { -max_val, max_val };
+
+  NumericBuilder<ArrowType> builder;
+  ARROW_RETURN_NOT_OK(builder.Reserve(length));
+  for (int64_t ndx = 0; ndx < length; ++ndx) {
+    builder.UnsafeAppend(dist(rng));
+  }
+
+  return builder.Finish();
+}
+
+/** Copies `input_arr`, replacing every `null_period`th value (starting at 0) with a null. */
+Result<shared_ptr<Array>>
+WithNulls(const arrow::Int64Array &input_arr, int64_t null_period) {
+  NumericBuilder<Int64Type> builder;
+  ARROW_RETURN_NOT_OK(builder.Reserve(input_arr.length()));
+  for (int64_t ndx = 0; ndx < input_arr.length(); ++ndx) {
+    if (ndx % null_period == 0) { builder.UnsafeAppendNull();               }
+    else                        { builder.UnsafeAppend(input_arr.Value(ndx)); }
+  }
+
+  return builder.Finish();
+}
+
+/** Calls `func_name` on `arg` `repeat` times and returns the fastest call in ms. */
+Result<double>
+TimeFunction(const string &func_name, const Datum &arg, int repeat) {
+  double best_ms = std::numeric_limits<double>::max();
+
+  for (int iter = 0; iter < repeat; ++iter) {
+    auto tstart = steady_clock::now();
+    ARROW_RETURN_NOT_OK(CallFunction(func_name, { arg }));
+    auto tstop  = steady_clock::now();
+
+    std::chrono::duration<double, std::milli> elapsed = tstop - tstart;
+    best_ms = std::min(best_ms, elapsed.count());
+  }
+
+  return best_ms;
+}
+
+/**
+ * Times a recipe function against the built-in function it mirrors, after checking that
+ * both produce the same result.
+ */
+Status
+CompareFunctions( const string &type_name
+                 ,const string &recipe_fn
+                 ,const string &builtin_fn
+                 ,const Datum  &arg
+                 ,int           repeat) {
+  ARROW_ASSIGN_OR_RAISE(Datum recipe_result , CallFunction(recipe_fn , { arg }));
+  ARROW_ASSIGN_OR_RAISE(Datum builtin_result, CallFunction(builtin_fn, { arg }));
+  if (not recipe_result.Equals(builtin_result)) {
+    return Status::Invalid(recipe_fn, " and ", builtin_fn, " differ for ", type_name);
+  }
+
+  ARROW_ASSIGN_OR_RAISE(double recipe_ms , TimeFunction(recipe_fn , arg, repeat));
+  ARROW_ASSIGN_OR_RAISE(double builtin_ms, TimeFunction(builtin_fn, arg, repeat));
+
+  std::cout << type_name                               << "\t"
+            << recipe_fn  << ": " << recipe_ms  << " ms" << "\t"
+            << builtin_fn << ": " << builtin_ms << " ms" << std::endl
+  ;
+
+  return Status::OK();
+}
+
+Status
+RunComparisons(int64_t length, int repeat) {
+  ARROW_ASSIGN_OR_RAISE(auto int32_arr , BuildRandomArray<Int32Type> (length, 1 << 30));
+  ARROW_ASSIGN_OR_RAISE(auto int64_arr , BuildRandomArray<Int64Type> (length, 1LL << 62));
+  ARROW_ASSIGN_OR_RAISE(auto double_arr, BuildRandomArray<DoubleType>(length, 1e6));
+
+  vector<std::pair<string, Datum>> test_args {
+     { "int32" , Datum(int32_arr)  }
+    ,{ "int64" , Datum(int64_arr)  }
+    ,{ "double", Datum(double_arr) }
+  };
+
+  for (const auto &test_arg : test_args) {
+    ARROW_RETURN_NOT_OK(
+      CompareFunctions(test_arg.first, "absolute_value", "abs", test_arg.second, repeat)
+    );
+
+    ARROW_RETURN_NOT_OK(
+      CompareFunctions(
+         test_arg.first
+        ,"absolute_value_checked"
+        ,"abs_checked"
+        ,test_arg.second
+        ,repeat
+      )
+    );
+  }
+
+  return Status::OK();
+}
+
+/**
+ * Shows that `AbsoluteValueInPlace` writes into the input's buffer when it is the only owner,
+ * and into a new buffer when another array still references the input.
+ */
+Status
+RunInPlace(int64_t length) {
+  ARROW_ASSIGN_OR_RAISE(auto int64_arr, BuildRandomArray<Int64Type>(length, 1LL << 62));
+
+  // >> Shared: `int64_arr` still references the input, so it must not change
+  const uint8_t *shared_data = int64_arr->data()->buffers[1]->data();
+  ARROW_ASSIGN_OR_RAISE(Datum shared_result, AbsoluteValueInPlace(Datum(int64_arr)));
+
+  // >> Exclusive: drop every other reference before handing the input over
+  Datum exclusive_arg { int64_arr->data() };
+  int64_arr.reset();
+
+  const uint8_t *exclusive_data = exclusive_arg.array()->buffers[1]->data();
+  ARROW_ASSIGN_OR_RAISE(
+     Datum exclusive_result
+    ,AbsoluteValueInPlace(std::move(exclusive_arg))
+  );
+
+  if (not exclusive_result.Equals(shared_result)) {
+    return Status::Invalid("In-place and out-of-place results differ");
+  }
+
+  std::cout << "In place (shared input)   : "
+            << (shared_result.array()->buffers[1]->data()    == shared_data    ? "yes" : "no")
+            << std::endl
+            << "In place (exclusive input): "
+            << (exclusive_result.array()->buffers[1]->data() == exclusive_data ? "yes" : "no")
+            << std::endl
+  ;
+
+  return Status::OK();
+}
+
+/** Calls each function in `func_names` on the previous one's result; returns the last. */
+Result<Datum>
+CallChain(const vector<string> &func_names, const Datum &arg) {
+  Datum result = arg;
+  for (const auto &func_name : func_names) {
+    ARROW_ASSIGN_OR_RAISE(result, CallFunction(func_name, { result }));
+  }
+
+  return result;
+}
+
+/**
+ * Times a fused function against the chain of built-in functions it replaces, after
+ * checking that both produce the same result.
+ */
+Status
+RunFused(int64_t length, int repeat) {
+  // built-in "log1p" only accepts integers that convert to doubles exactly
+  ARROW_ASSIGN_OR_RAISE(auto int64_arr, BuildRandomArray<Int64Type>(length, 1LL << 52));
+  Datum          arg        { int64_arr };
+  vector<string> chain_fns  { "abs", "log1p" };
+
+  ARROW_ASSIGN_OR_RAISE(Datum fused_result, CallFunction("abs_log1p", { arg }));
+  ARROW_ASSIGN_OR_RAISE(Datum chain_result, CallChain(chain_fns, arg));
+  if (not fused_result.Equals(chain_result)) {
+    return Status::Invalid("abs_log1p and abs -> log1p differ");
+  }
+
+  double fused_ms = std::numeric_limits<double>::max();
+  double chain_ms = std::numeric_limits<double>::max();
+  for (int iter = 0; iter < repeat; ++iter) {
+    auto tstart = steady_clock::now();
+    ARROW_RETURN_NOT_OK(CallFunction("abs_log1p", { arg }));
+    auto tsplit = steady_clock::now();
+    ARROW_RETURN_NOT_OK(CallChain(chain_fns, arg));
+    auto tstop  = steady_clock::now();
+
+    std::chrono::duration<double, std::milli> fused_elapsed = tsplit - tstart;
+    std::chrono::duration<double, std::milli> chain_elapsed = tstop  - tsplit;
+    fused_ms = std::min(fused_ms, fused_elapsed.count());
+    chain_ms = std::min(chain_ms, chain_elapsed.count());
+  }
+
+  std::cout << "int64"                              << "\t"
+            << "abs_log1p: "    << fused_ms << " ms" << "\t"
+            << "abs -> log1p: " << chain_ms << " ms" << std::endl
+  ;
+
+  return Status::OK();
+}
+
+
+/**
+ * Checks that the fused hash functions give the same hashes (and nulls) as hashing the
+ * materialized output of the chains they replace, on input with and without nulls:
+ *  - "abs_log1p_hash"      : abs -> log1p -> named_scalar_fn
+ *  - "abs_log1p_scale_hash": abs -> log1p -> multiply (by 1000) -> named_scalar_fn
+ *
+ * The inputs are longer than a minibatch, so more than one tile is hashed.
+ */
+Status
+RunFusedHash(int64_t length) {
+  ARROW_ASSIGN_OR_RAISE(auto int64_arr, BuildRandomArray<Int64Type>(length, 1LL << 52));
+  ARROW_ASSIGN_OR_RAISE(
+     auto nulls_arr
+    ,WithNulls(static_cast<const arrow::Int64Array&>(*int64_arr), 7)
+  );
+
+  for (const auto &input_arr : { int64_arr, nulls_arr }) {
+    Datum arg { input_arr };
+
+    ARROW_ASSIGN_OR_RAISE(Datum fused_hashes, CallFunction("abs_log1p_hash", { arg }));
+    ARROW_ASSIGN_OR_RAISE(Datum log1p_vals  , CallChain({ "abs", "log1p" }, arg));
+    ARROW_ASSIGN_OR_RAISE(Datum chain_hashes, CallFunction("named_scalar_fn", { log1p_vals }));
+    if (not fused_hashes.Equals(chain_hashes)) {
+      return Status::Invalid("abs_log1p_hash and abs -> log1p -> named_scalar_fn differ");
+    }
+
+    ARROW_ASSIGN_OR_RAISE(Datum scaled_hashes, CallFunction("abs_log1p_scale_hash", { arg }));
+    ARROW_ASSIGN_OR_RAISE(
+       Datum scaled_vals
+      ,CallFunction("multiply", { log1p_vals, Datum(1000.0) })
+    );
+    ARROW_ASSIGN_OR_RAISE(Datum scaled_chain, CallFunction("named_scalar_fn", { scaled_vals }));
+    if (not scaled_hashes.Equals(scaled_chain)) {
+      return Status::Invalid(
+        "abs_log1p_scale_hash and abs -> log1p -> multiply -> named_scalar_fn differ"
+      );
+    }
+  }
+
+  std::cout << "abs_log1p_hash, abs_log1p_scale_hash: match their chains"
+            << " (with and without nulls)"                                  << std::endl
+  ;
+
+  return Status::OK();
+}
+
+
+int main(int argc, char **argv) {
+  int64_t length = (argc > 1) ? std::stoll(argv[1]) : 10000000;
+  int     repeat = (argc > 2) ? std::stoi (argv[2]) : 5;
+
+  // >> Register the recipe functions next to the built-in functions
+  RegisterNamedScalarFn(arrow::compute::GetFunctionRegistry());
+  RegisterAbsoluteValueFunctions(arrow::compute::GetFunctionRegistry());
+  RegisterFusedFunctions(arrow::compute::GetFunctionRegistry());
+
+  // >> Compare them
+  std::cout << "Array length: " << length << " (best of " << repeat << ")" << std::endl;
+  auto compare_status = RunComparisons(length, repeat);
+  if (not compare_status.ok()) {
+    std::cerr << compare_status.message() << std::endl;
+    return 1;
+  }
+
+  auto fused_status = RunFused(length, repeat);
+  if (not fused_status.ok()) {
+    std::cerr << fused_status.message() << std::endl;
+    return 1;
+  }
+
+  auto fused_hash_status = RunFusedHash(std::min<int64_t>(length, 100000));
+  if (not fused_hash_status.ok()) {
+    std::cerr << fused_hash_status.message() << std::endl;
+    return 1;
+  }
+
+  auto inplace_status = RunInPlace(length);
+  if (not inplace_status.ok()) {
+    std::cerr << inplace_status.message() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -8,6 +8,30 @@
 // Macros and aliases
 
 
+// ------------------------------
+// Options
+
+const FunctionOptionsType*
+GetInPlaceOptionsType() {
+  static const RecipeOptionsType<InPlaceOptions> options_type;
+  return &options_type;
+}
+
+InPlaceOptions::InPlaceOptions(bool reuse_input)
+  : FunctionOptions(GetInPlaceOptionsType())
+   ,reuse_input(reuse_input) {}
+
+string
+InPlaceOptions::Describe() const {
+  return string("InPlaceOptions(reuse_input=") + (reuse_input ? "true" : "false") + ")";
+}
+
+bool
+InPlaceOptions::IsEqual(const InPlaceOptions &other) const {
+  return reuse_input == other.reuse_input;
+}
+
+
 // ------------------------------
 // Named Functions
 
@@ -22,11 +46,47 @@
  */
 Result<Datum>
 AbsoluteValue(const Datum& arg, ArithmeticOptions options, ExecContext* ctx) {
-	auto func_name = (options.check_overflow) ?  "abs_checked" : "abs";
+  auto func_name = (options.check_overflow) ? "absolute_value_checked" : "absolute_value";
 
   return CallFunction(func_name, { arg }, ctx);
 }
 
+/**
+ * Returns true if `arg` holds the only reference to each `ArrayData` it contains. Arrays
+ * constructed from the same `ArrayData` share its buffers, so writing into a shared
+ * `ArrayData` would change another array's values.
+ */
+bool
+IsExclusivelyOwned(const Datum &arg) {
+  if (arg.is_array()) { return arg.array().use_count() == 1; }
+
+  if (arg.is_chunked_array()) {
+    if (arg.chunked_array().use_count() != 1) { return false; }
+
+    for (const auto &chunk : arg.chunked_array()->chunks()) {
+      if (chunk.use_count() != 1 or chunk->data().use_count() != 1) { return false; }
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+/*
+ * Like `AbsoluteValue`, but takes ownership of `arg` and writes the result over its data
+ * buffers when nothing else references them.
+ */
+Result<Datum>
+AbsoluteValueInPlace(Datum&& arg, ArithmeticOptions options, ExecContext* ctx) {
+  auto func_name = (options.check_overflow) ? "absolute_value_checked" : "absolute_value";
+
+  vector<Datum>  fn_args { std::move(arg) };
+  InPlaceOptions fn_opts { IsExclusivelyOwned(fn_args[0]) };
+
+  return CallFunction(func_name, fn_args, &fn_opts, ctx);
+}
+
 
 //  |> documentation
 
@@ -39,8 +99,8 @@ AbsoluteValue(const Datum& arg, ArithmeticOptions options, ExecContext* ctx) {
 const FunctionDoc absolute_value_doc {
    "Calculate the absolute value of the argument element-wise"
   ,(
-     "Results will wrap around on integer overflow."
-     "Use function 'absolute_value_checked' if you want overflow"
+     "Results will wrap around on integer overflow.\n"
+     "Use function 'absolute_value_checked' if you want overflow\n"
      "to return an error."
    )
   ,{ "x" }
@@ -49,8 +109,8 @@ const FunctionDoc absolute_value_doc {
 const FunctionDoc absolute_value_checked_doc {
    "Calculate the absolute value of the argument element-wise"
   ,(
-     "This function returns an error on overflow. For a variant that"
-     "doesn’t fail on overflow, use function 'absolute_value_checked'."
+     "This function returns an error on overflow. For a variant that\n"
+     "doesn't fail on overflow, use function 'absolute_value'."
    )
   ,{ "x" }
 };
@@ -67,92 +127,239 @@ const FunctionDoc absolute_value_checked_doc {
  */
 
 /**
- * Kernels for AbsoluteValue that do not do extra checking for overflow.
+ * The kernels registered below don't apply the ops in "example.hpp" one element at a time. Instead,
+ * each kernel calls an explicit SIMD loop (see "simd-kernels.hpp") that was selected for
+ * this CPU when the kernel was registered. The loops compute the same results as
+ * `AbsoluteValue::Call`, and the checked loops detect overflow with a single OR-reduction
+ * rather than a branch per negative element.
+ *
+ * The selected loop is stored in the kernel's `data`, which kernels can access through
+ * `KernelContext::kernel()`.
  */
-struct AbsoluteValue {
+template <typename CType>
+struct AbsLoopData : public KernelState {
+  explicit AbsLoopData(AbsLoop<CType> loop) : loop(loop) {}
+
+  AbsLoop<CType> loop;
+};
+
+template <typename CType, bool kChecked>
+struct AbsoluteValueSimd {
+
   /**
-   * If the input type is a float (non-integer), check if it is negative.
+   * The loops run over null slots too (which is cheaper than skipping them), and a null
+   * slot may hold the minimum value. So, when a loop reports overflow for an input with
+   * nulls, we confirm it using only valid slots.
    */
-  template <typename T, typename Arg>
-  static constexpr enable_if_floating_point<T>
-  Call(KernelContext*, Arg arg, Status*) {
-    // if the argument is less than 0, return the argument after negation (make it
-    // positive).
-    return (arg < static_cast<T>(0)) ? -arg : arg;
+  static bool
+  OverflowInValidSlots(const ArraySpan &input_arr) {
+    if (input_arr.GetNullCount() == 0) { return true; }
+
+    const CType *input_vals = input_arr.GetValues<CType>(1);
+    for (int64_t ndx = 0; ndx < input_arr.length; ++ndx) {
+      if (    input_arr.IsValid(ndx)
+          and input_vals[ndx] == std::numeric_limits<CType>::min()) {
+        return true;
+      }
+    }
+
+    return false;
   }
 
   /**
-   * If the input type is a signed integer, check if it is negative.
+   * Returns true if the output can be written over the input's data buffer. The buffer must
+   * be mutable CPU memory that no other `ArrayData` (or parent buffer) references.
+   *
+   * A buffer's reference count can't tell us whether other arrays share the input's
+   * `ArrayData`, so kernels only check this when the caller asked for `reuse_input` (see
+   * `AbsoluteValueInPlace`, which checks the rest).
    */
-  template <typename T, typename Arg>
-  static constexpr enable_if_signed_integer<T>
-  Call(KernelContext*, Arg arg, Status* st) {
-    return (arg < static_cast<T>(0)) ? arrow::internal::SafeSignedNegate(arg) : arg;
+  static bool
+  CanWriteInPlace(const ArraySpan &input_arr) {
+    const shared_ptr<arrow::Buffer> *data_owner = input_arr.buffers[1].owner;
+
+    return (
+          data_owner != nullptr
+      and data_owner->use_count() == 1
+      and (*data_owner)->is_mutable()
+      and (*data_owner)->is_cpu()
+      and (*data_owner)->parent() == nullptr
+    );
   }
 
   /**
-   * If the input type is an unsigned integer, then it can't be negative.
+   * Returns a validity buffer for an output with offset `out_offset`. The input's bitmap is
+   * shared when the offsets line up, and copied otherwise.
    */
-  template <typename T, typename Arg>
-  static constexpr enable_if_unsigned_integer<T>
-  Call(KernelContext*, Arg arg, Status*) {
-      return arg;
-  }
-};
+  static Result<shared_ptr<arrow::Buffer>>
+  OutputValidity(KernelContext *ctx, const ArraySpan &input_arr, int64_t out_offset) {
+    if (input_arr.buffers[0].data == nullptr or input_arr.GetNullCount() == 0) {
+      return nullptr;
+    }
 
-/**
- * Kernels for AbsoluteValue that are "safe" because they check for overflow when negating.
- */
-struct AbsoluteValueChecked {
+    if (input_arr.offset == out_offset and input_arr.buffers[0].owner != nullptr) {
+      return *input_arr.buffers[0].owner;
+    }
 
-  /**
-   * If the input type is a float (non-integer), assert that the argument is of the
-   * expected type, then check if it is negative.
-   */
-  template <typename T, typename Arg>
-  static constexpr enable_if_floating_point<T>
-  Call(KernelContext*, Arg arg, Status* st) {
-    static_assert(std::is_same<T, Arg>::value, "");
-    return (arg < static_cast<T>(0)) ? -arg : arg;
+    return arrow::internal::CopyBitmap(
+       ctx->memory_pool()
+      ,input_arr.buffers[0].data
+      ,input_arr.offset
+      ,input_arr.length
+    );
   }
 
   /**
-   * If the input type is a signed integer, assert that the argument is of the expected
-   * type, then call `NegateWithOverflow`. If `NegateWithOverflow` returns true, then
-   * overflow occurred and we should return a non-successful status.
+   * These kernels allocate their own output (`NO_PREALLOCATE`), so that they can choose to
+   * return the input's data buffer instead of a new one. When writing in place, the output
+   * keeps the input's offset so that it lines up with the reused buffer.
    */
-  template <typename T, typename Arg>
-  static enable_if_signed_integer<T>
-  Call(KernelContext*, Arg arg, Status* st) {
-    static_assert(std::is_same<T, Arg>::value, "");
+  static Status
+  Exec(KernelContext *ctx, const ExecSpan &input_arg, ExecResult *out) {
+    RECIPE_TRACE_KERNEL(
+       kChecked ? "absolute_value_checked" : "absolute_value"
+      ,input_arg.length
+    );
+    const ArraySpan &input_arr = input_arg[0].array;
+    const auto      &options   = OptionsState<InPlaceOptions>::Get(ctx);
 
-    if (arg < static_cast<T>(0)) {
-      T result = 0;
+    // >> Choose the output's data buffer
+    shared_ptr<arrow::Buffer> out_values;
+    int64_t                   out_offset = 0;
 
-      /// `ARROW_PREDICT_FALSE` is a macro to help with branch prediction
-      if (ARROW_PREDICT_FALSE(NegateWithOverflow(arg, &result))) {
-        *st = Status::Invalid("overflow");
-      }
+    if (options.reuse_input and CanWriteInPlace(input_arr)) {
+      out_values = *input_arr.buffers[1].owner;
+      out_offset = input_arr.offset;
+    }
 
-      return result;
+    else {
+      ARROW_ASSIGN_OR_RAISE(out_values, ctx->Allocate(input_arr.length * sizeof(CType)));
+      RECIPE_TRACE_ALLOCATED(out_values->size());
     }
 
-    return arg;
-  }
+    // >> Compute absolute values
+    auto loop_data  = static_cast<const AbsLoopData<CType>*>(ctx->kernel()->data.get());
+    bool overflowed = loop_data->loop(
+       input_arr.GetValues<CType>(1)
+      ,reinterpret_cast<CType*>(out_values->mutable_data()) + out_offset
+      ,input_arr.length
+    );
 
-  /**
-   * If the input type is an unsigned integer, assert that the argument is of the expected
-   * type, then return the argument because it cannot be negative.
-   */
-  template <typename T, typename Arg>
-  static enable_if_unsigned_integer<T>
-  Call(KernelContext* ctx, Arg arg, Status* st) {
-    static_assert(std::is_same<T, Arg>::value, "");
-    return arg;
+    // NOTE: when writing in place, the input has already been overwritten at this point
+    if (kChecked and overflowed and OverflowInValidSlots(input_arr)) {
+      return Status::Invalid("overflow");
+    }
+
+    // >> Assemble the output; nulls are the same as the input's
+    ARROW_ASSIGN_OR_RAISE(auto out_validity, OutputValidity(ctx, input_arr, out_offset));
+    out->value = arrow::ArrayData::Make(
+       input_arr.type->GetSharedPtr()
+      ,input_arr.length
+      ,{ std::move(out_validity), std::move(out_values) }
+      ,input_arr.null_count
+      ,out_offset
+    );
+
+    return Status::OK();
   }
 };
 
 
+/**
+ * A kernel for the null type: every output element is null, so there is nothing to
+ * compute. This replaces arrow's internal `AddNullExec`.
+ */
+Status
+ExecNull(KernelContext*, const ExecSpan &input_arg, ExecResult *out) {
+  out->value = std::make_shared<arrow::NullArray>(input_arg.length)->data();
+  return Status::OK();
+}
+
+void
+AddNullKernel(ScalarFunction *fn_absolutevalue) {
+  ScalarKernel kernel {
+     { InputType(arrow::null()) }
+    ,OutputType(arrow::null())
+    ,ExecNull
+  };
+
+  kernel.null_handling  = NullHandling::COMPUTED_NO_PREALLOCATE;
+  kernel.mem_allocation = MemAllocation::NO_PREALLOCATE;
+  DCHECK_OK(fn_absolutevalue->AddKernel(std::move(kernel)));
+}
+
+template <typename CType, bool kChecked>
+void
+AddAbsoluteValueKernel( ScalarFunction                    *fn_absolutevalue
+                       ,const shared_ptr<arrow::DataType> &numeric_type
+                       ,SimdLevel                          simd_level) {
+  ScalarKernel kernel {
+     { InputType(numeric_type) }
+    ,OutputType(numeric_type)
+    ,AbsoluteValueSimd<CType, kChecked>::Exec
+    ,OptionsState<InPlaceOptions>::Init
+  };
+
+  kernel.data                  = std::make_shared<AbsLoopData<CType>>(
+    SelectAbsLoop<CType>(simd_level)
+  );
+  kernel.null_handling         = NullHandling::COMPUTED_NO_PREALLOCATE;
+  kernel.mem_allocation        = MemAllocation::NO_PREALLOCATE;
+  kernel.can_write_into_slices = false;
+  DCHECK_OK(fn_absolutevalue->AddKernel(std::move(kernel)));
+}
+
+/**
+ * Adds a kernel for each numeric type (and the null type) to `fn_absolutevalue`. This
+ * maps each arrow type to its C type, which is what the SIMD loops are templated on.
+ */
+template <bool kChecked>
+void
+AddAbsoluteValueKernels(ScalarFunction *fn_absolutevalue, SimdLevel simd_level) {
+  for (const auto &numeric_type : NumericTypes()) {
+    switch (numeric_type->id()) {
+      case arrow::Type::INT8:
+        AddAbsoluteValueKernel<int8_t  , kChecked>(fn_absolutevalue, numeric_type, simd_level);
+        break;
+      case arrow::Type::INT16:
+        AddAbsoluteValueKernel<int16_t , kChecked>(fn_absolutevalue, numeric_type, simd_level);
+        break;
+      case arrow::Type::INT32:
+        AddAbsoluteValueKernel<int32_t , kChecked>(fn_absolutevalue, numeric_type, simd_level);
+        break;
+      case arrow::Type::INT64:
+        AddAbsoluteValueKernel<int64_t , kChecked>(fn_absolutevalue, numeric_type, simd_level);
+        break;
+      case arrow::Type::UINT8:
+        AddAbsoluteValueKernel<uint8_t , kChecked>(fn_absolutevalue, numeric_type, simd_level);
+        break;
+      case arrow::Type::UINT16:
+        AddAbsoluteValueKernel<uint16_t, kChecked>(fn_absolutevalue, numeric_type, simd_level);
+        break;
+      case arrow::Type::UINT32:
+        AddAbsoluteValueKernel<uint32_t, kChecked>(fn_absolutevalue, numeric_type, simd_level);
+        break;
+      case arrow::Type::UINT64:
+        AddAbsoluteValueKernel<uint64_t, kChecked>(fn_absolutevalue, numeric_type, simd_level);
+        break;
+      case arrow::Type::FLOAT:
+        AddAbsoluteValueKernel<float   , kChecked>(fn_absolutevalue, numeric_type, simd_level);
+        break;
+      case arrow::Type::DOUBLE:
+        AddAbsoluteValueKernel<double  , kChecked>(fn_absolutevalue, numeric_type, simd_level);
+        break;
+
+      // e.g. half floats, which have no native C type
+      default:
+        break;
+    }
+  }
+
+  // Register a kernel that has a null output type if all input args are null.
+  AddNullKernel(fn_absolutevalue);
+}
+
+
 // ------------------------------
 // Registration
 
@@ -161,22 +368,19 @@ struct AbsoluteValueChecked {
  * "absolute_value" and registers unchecked versions of the AbsoluteValue kernel.
  */
 shared_ptr<ScalarFunction>
-RegisterUncheckedAbsoluteValueKernels() {
+RegisterUncheckedAbsoluteValueKernels(SimdLevel simd_level) {
   // Instantiate a function to be registered
-  auto fn_absolutevalue = std::make_shared<ArithmeticFunction>(
+  static const InPlaceOptions default_options = InPlaceOptions::Defaults();
+
+  auto fn_absolutevalue = std::make_shared<ScalarFunction>(
      "absolute_value"
     ,Arity::Unary()
-    ,std::move(&absolute_value_doc)
+    ,absolute_value_doc
+    ,&default_options
   );
 
   // Register a kernel for each data type we want this function to accommodate
-  for (const auto& numeric_type : NumericTypes()) {
-    auto exec = ArithmeticExecFromOp<ScalarUnary, AbsoluteValue>(numeric_type);
-    DCHECK_OK(fn_absolutevalue->AddKernel({ numeric_type }, numeric_type, exec));
-  }
-
-  // Register a kernel that has a null output type if all input args are null.
-  AddNullExec(fn_absolutevalue.get());
+  AddAbsoluteValueKernels</*kChecked=*/false>(fn_absolutevalue.get(), simd_level);
 
   return fn_absolutevalue;
 }
@@ -186,23 +390,20 @@ RegisterUncheckedAbsoluteValueKernels() {
  * "absolute_value_checked" and registers checked versions of the AbsoluteValue kernel.
  */
 shared_ptr<ScalarFunction>
-RegisterCheckedAbsoluteValueKernels() {
+RegisterCheckedAbsoluteValueKernels(SimdLevel simd_level) {
 
   // Instantiate a function to be registered
-  auto fn_absolutevalue_checked = std::make_shared<ArithmeticFunction>(
+  static const InPlaceOptions default_options = InPlaceOptions::Defaults();
+
+  auto fn_absolutevalue_checked = std::make_shared<ScalarFunction>(
      "absolute_value_checked"
     ,Arity::Unary()
-    ,std::move(&absolute_value_checked_doc)
+    ,absolute_value_checked_doc
+    ,&default_options
   );
 
   // Register a kernel for each data type we want this function to accommodate
-  for (const auto& numeric_type : NumericTypes()) {
-    auto exec = ArithmeticExecFromOp<ScalarUnaryNotNull, AbsoluteValue>(numeric_type);
-    DCHECK_OK(fn_absolutevalue_checked->AddKernel({ numeric_type }, numeric_type, exec));
-  }
-
-  // Register a kernel that has a null output type if all input args are null.
-  AddNullExec(fn_absolutevalue_checked.get());
+  AddAbsoluteValueKernels</*kChecked=*/true>(fn_absolutevalue_checked.get(), simd_level);
 
   return fn_absolutevalue_checked;
 }
@@ -211,47 +412,22 @@ RegisterCheckedAbsoluteValueKernels() {
 /**
  * A convenience function that takes a `FunctionRegistry` pointer as an input argument.
  *
- * This function calls 2 other convenience functions, then registers the returned
- * `ScalarFunction` instance from each in the input `FunctionRegistry`. The called
- * convenience functions are:
+ * This function selects SIMD kernels for this CPU, calls 2 other convenience functions,
+ * then registers the returned `ScalarFunction` instance from each in the input
+ * `FunctionRegistry`. The called convenience functions are:
  *  - `RegisterUncheckedAbsoluteValueKernels()`
  *  - `RegisterCheckedAbsoluteValueKernels()`
  */
 void
-RegisterAbsolueValueFunctions(FunctionRegistry *registry) {
-  auto kernel_unchecked = RegisterUncheckedAbsoluteValueKernels();
-	DCHECK_OK(registry->AddFunction(std::move(kernel_unchecked)));
-
-  auto kernel_checked = RegisterCheckedAbsoluteValueKernels();
-  DCHECK_OK(registry->AddFunction(std::move(kernel_checked)));
-}
-
-
-
-/*
-struct ScalarUnary {
-  static Status
-  ExecArray(KernelContext *ctx, const ExecSpan &input_arg, ExecResult *out) {
-    Status st = Status::OK();
-
-    ArrayIterator<Int32> input_itr(input_arg[0].array);
-
-    RETURN_NOT_OK(
-      OutputAdapter<Int32>::Write(
-         ctx
-        ,out->array_span()
-        ,[&]() -> int32_t {
-           return AbsoluteValue::template Call<int32_t, int32_t>(ctx, input_itr(), &st);
-         }
-      )
-    );
-
-    return st;
-  }
-};
+RegisterAbsoluteValueFunctions(FunctionRegistry *registry) {
+  // Choose kernels once, for the CPU we're running on
+  auto hardware_flags = default_exec_context()->cpu_info()->hardware_flags();
+  auto simd_level     = SimdLevelFromFlags(hardware_flags);
+  ARROW_LOG(INFO) << "Registering absolute value kernels for: " << SimdLevelName(simd_level);
 
+  auto kernel_unchecked = RegisterUncheckedAbsoluteValueKernels(simd_level);
+  DCHECK_OK(registry->AddFunction(std::move(kernel_unchecked)));
 
-{
-  DCHECK_OK(fn_absolutevalue->AddKernel({ numeric_type }, numeric_type, ScalarUnary::ExecArray));
+  auto kernel_checked = RegisterCheckedAbsoluteValueKernels(simd_level);
+  DCHECK_OK(registry->AddFunction(std::move(kernel_checked)));
 }
-*/
@@ -6,6 +6,155 @@
 
 // consolidated dependencies to keep this header concise
 #include "support.hpp"
+#include "simd-kernels.hpp"
+
+#include <type_traits>
+#include <arrow/util/bitmap_ops.h>
+#include <arrow/util/int_util_overflow.h>
+
+
+// ------------------------------
+// Macros and aliases
+
+using arrow::NumericTypes;
+using arrow::compute::ArithmeticOptions;
+using arrow::internal::NegateWithOverflow;
+
+// >> SFINAE helpers for kernel ops, which are templated on C types. Arrow defines the same
+//    helpers in an internal header, which isn't installed.
+template <typename T, typename R = T>
+using enable_if_floating_point = std::enable_if_t<std::is_floating_point<T>::value, R>;
+
+template <typename T, typename R = T>
+using enable_if_signed_integer = std::enable_if_t<
+  std::is_integral<T>::value and std::is_signed<T>::value, R
+>;
+
+template <typename T, typename R = T>
+using enable_if_unsigned_integer = std::enable_if_t<
+  std::is_integral<T>::value and std::is_unsigned<T>::value, R
+>;
+
+
+// ------------------------------
+// Classes
+
+// >> Options for unary arithmetic functions
+/**
+ * Options for "absolute_value" and "absolute_value_checked". When `reuse_input` is true,
+ * the caller promises that nothing else uses the input's `ArrayData`, and kernels may
+ * write the result over the input's data buffer (if that buffer isn't shared either).
+ * Prefer `AbsoluteValueInPlace`, which verifies the promise before making it.
+ *
+ * If a checked function fails with overflow, an input that was reused is left partially
+ * overwritten.
+ */
+class ARROW_EXPORT InPlaceOptions : public FunctionOptions {
+  public:
+    explicit InPlaceOptions(bool reuse_input = false);
+
+    static constexpr char kTypeName[] = "InPlaceOptions";
+    static InPlaceOptions Defaults() { return InPlaceOptions(); }
+
+    string Describe()                            const;
+    bool   IsEqual(const InPlaceOptions &other) const;
+
+    bool reuse_input;
+};
+
+
+// >> Elementwise ops
+/**
+ * Ops are structs with a static `Call<T, Arg>` template that computes one output value of
+ * type `T` from one input value of type `Arg`. They're declared here, rather than next to
+ * the kernels in "example.cc", so that they can be composed with other ops (see
+ * "fusion.hpp").
+ */
+/**
+ * Kernels for AbsoluteValue that do not do extra checking for overflow.
+ */
+struct AbsoluteValue {
+  /**
+   * If the input type is a float (non-integer), check if it is negative.
+   */
+  template <typename T, typename Arg>
+  static constexpr enable_if_floating_point<T>
+  Call(KernelContext*, Arg arg, Status*) {
+    // if the argument is less than 0, return the argument after negation (make it
+    // positive).
+    return (arg < static_cast<T>(0)) ? -arg : arg;
+  }
+
+  /**
+   * If the input type is a signed integer, check if it is negative.
+   */
+  template <typename T, typename Arg>
+  static constexpr enable_if_signed_integer<T>
+  Call(KernelContext*, Arg arg, Status* st) {
+    return (arg < static_cast<T>(0)) ? arrow::internal::SafeSignedNegate(arg) : arg;
+  }
+
+  /**
+   * If the input type is an unsigned integer, then it can't be negative.
+   */
+  template <typename T, typename Arg>
+  static constexpr enable_if_unsigned_integer<T>
+  Call(KernelContext*, Arg arg, Status*) {
+      return arg;
+  }
+};
+
+/**
+ * Kernels for AbsoluteValue that are "safe" because they check for overflow when negating.
+ */
+struct AbsoluteValueChecked {
+
+  /**
+   * If the input type is a float (non-integer), assert that the argument is of the
+   * expected type, then check if it is negative.
+   */
+  template <typename T, typename Arg>
+  static constexpr enable_if_floating_point<T>
+  Call(KernelContext*, Arg arg, Status* st) {
+    static_assert(std::is_same<T, Arg>::value, "");
+    return (arg < static_cast<T>(0)) ? -arg : arg;
+  }
+
+  /**
+   * If the input type is a signed integer, assert that the argument is of the expected
+   * type, then call `NegateWithOverflow`. If `NegateWithOverflow` returns true, then
+   * overflow occurred and we should return a non-successful status.
+   */
+  template <typename T, typename Arg>
+  static enable_if_signed_integer<T>
+  Call(KernelContext*, Arg arg, Status* st) {
+    static_assert(std::is_same<T, Arg>::value, "");
+
+    if (arg < static_cast<T>(0)) {
+      T result = 0;
+
+      /// `ARROW_PREDICT_FALSE` is a macro to help with branch prediction
+      if (ARROW_PREDICT_FALSE(NegateWithOverflow(arg, &result))) {
+        *st = Status::Invalid("overflow");
+      }
+
+      return result;
+    }
+
+    return arg;
+  }
+
+  /**
+   * If the input type is an unsigned integer, assert that the argument is of the expected
+   * type, then return the argument because it cannot be negative.
+   */
+  template <typename T, typename Arg>
+  static enable_if_unsigned_integer<T>
+  Call(KernelContext* ctx, Arg arg, Status* st) {
+    static_assert(std::is_same<T, Arg>::value, "");
+    return arg;
+  }
+};
 
 
 // ------------------------------
@@ -21,3 +170,21 @@ ARROW_EXPORT
 Result<Datum> AbsoluteValue( const Datum             &arg
                             ,      ArithmeticOptions  options = ArithmeticOptions()
                             ,      ExecContext       *ctx     = NULLPTR);
+
+/*
+ * Like `AbsoluteValue`, but takes ownership of `arg`. If `arg` holds the only reference to
+ * its data, the result is written over it instead of into a new buffer, which halves
+ * peak memory for chains of elementwise transforms.
+ */
+ARROW_EXPORT
+Result<Datum> AbsoluteValueInPlace( Datum            &&arg
+                                   ,ArithmeticOptions  options = ArithmeticOptions()
+                                   ,ExecContext       *ctx     = NULLPTR);
+
+/*
+ * Registers "absolute_value" and "absolute_value_checked" with kernels for the widest
+ * instruction set that this CPU supports.
+ */
+ARROW_EXPORT
+void
+RegisterAbsoluteValueFunctions(FunctionRegistry *registry);
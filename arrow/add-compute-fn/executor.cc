@@ -0,0 +1,338 @@
+// ------------------------------
+// Dependencies
+
+#include "executor.hpp"
+
+#include <atomic>
+#include <arrow/util/bitmap_ops.h>
+#include <arrow/util/parallel.h>
+#include <arrow/util/thread_pool.h>
+
+
+// ------------------------------
+// Classes
+
+// >> Resolution (once)
+ResolvedKernel::ResolvedKernel(ExecContext *ctx, const ScalarKernel *kernel)
+  : exec_ctx(ctx), kernel(kernel), kernel_ctx(ctx, kernel) {}
+
+/**
+ * Does the per-call work of `CallFunction` once: looks up `func_name`, dispatches to the
+ * best kernel for `in_types` (which may require casts), initializes the kernel's state
+ * with `options` (or the function's defaults) and resolves the output type.
+ */
+Result<std::unique_ptr<ResolvedKernel>>
+ResolvedKernel::Make( const string            &func_name
+                     ,const vector<TypeHolder> &in_types
+                     ,const FunctionOptions   *options
+                     ,ExecContext             *ctx) {
+  if (ctx == nullptr) { ctx = default_exec_context(); }
+
+  ARROW_ASSIGN_OR_RAISE(auto func, ctx->func_registry()->GetFunction(func_name));
+  if (func->kind() != arrow::compute::Function::SCALAR) {
+    return Status::NotImplemented("ResolvedKernel only supports scalar functions: ", func_name);
+  }
+
+  if (options == nullptr) { options = func->default_options(); }
+
+  // >> Dispatch; `kernel_types` is updated to the types the kernel expects
+  vector<TypeHolder> kernel_types = in_types;
+  ARROW_ASSIGN_OR_RAISE(auto kernel, func->DispatchBest(&kernel_types));
+
+  std::unique_ptr<ResolvedKernel> resolved {
+    new ResolvedKernel(ctx, static_cast<const ScalarKernel*>(kernel))
+  };
+
+  resolved->called_types = in_types;
+  resolved->kernel_types = kernel_types;
+  for (size_t arg_ndx = 0; arg_ndx < in_types.size(); ++arg_ndx) {
+    resolved->arg_needs_cast.push_back(in_types[arg_ndx] != kernel_types[arg_ndx]);
+  }
+
+  // >> Initialize kernel state, then resolve the output type (which may depend on it)
+  if (kernel->init) {
+    ARROW_ASSIGN_OR_RAISE(
+       resolved->kernel_state
+      ,kernel->init(&resolved->kernel_ctx, { kernel, kernel_types, options })
+    );
+
+    resolved->kernel_ctx.SetState(resolved->kernel_state.get());
+  }
+
+  ARROW_ASSIGN_OR_RAISE(
+     resolved->resolved_outtype
+    ,kernel->signature->out_type().Resolve(&resolved->kernel_ctx, kernel_types)
+  );
+
+  resolved->call_args.resize(in_types.size());
+  resolved->input_span.values.resize(in_types.size());
+
+  return resolved;
+}
+
+
+// >> Execution (per call)
+/**
+ * Computes the output validity for `NullHandling::INTERSECTION`: null when any argument
+ * is null. An argument's bitmap is shared when it's the only one with nulls and it lines
+ * up with the output (offset 0); otherwise, bitmaps are copied and combined.
+ */
+Result<shared_ptr<arrow::Buffer>>
+ResolvedKernel::IntersectValidity() {
+  shared_ptr<arrow::Buffer> out_validity;
+
+  for (const auto &input_val : input_span.values) {
+    const ArraySpan &input_arr = input_val.array;
+    if (input_arr.buffers[0].data == nullptr or input_arr.GetNullCount() == 0) { continue; }
+
+    if (out_validity != nullptr) {
+      ARROW_ASSIGN_OR_RAISE(
+         out_validity
+        ,arrow::internal::BitmapAnd(
+            exec_ctx->memory_pool()
+           ,out_validity->data(), 0
+           ,input_arr.buffers[0].data, input_arr.offset
+           ,input_span.length
+           ,0
+         )
+      );
+    }
+
+    else if (input_arr.offset == 0 and input_arr.buffers[0].owner != nullptr) {
+      out_validity = *input_arr.buffers[0].owner;
+    }
+
+    else {
+      ARROW_ASSIGN_OR_RAISE(
+         out_validity
+        ,arrow::internal::CopyBitmap(
+            exec_ctx->memory_pool()
+           ,input_arr.buffers[0].data
+           ,input_arr.offset
+           ,input_span.length
+         )
+      );
+    }
+  }
+
+  return out_validity;
+}
+
+/**
+ * Allocates what the compute framework would have allocated before calling the kernel: a
+ * validity bitmap, depending on `null_handling`, and a data buffer when the kernel is
+ * `PREALLOCATE` and its output is fixed-width.
+ */
+Result<std::shared_ptr<arrow::ArrayData>>
+ResolvedKernel::PreallocateOutput() {
+  int64_t                           out_length = input_span.length;
+  int64_t                           null_count = 0;
+  vector<shared_ptr<arrow::Buffer>> out_buffers(2);
+
+  switch (kernel->null_handling) {
+    case NullHandling::INTERSECTION: {
+      ARROW_ASSIGN_OR_RAISE(out_buffers[0], IntersectValidity());
+      if (out_buffers[0] != nullptr) { null_count = arrow::kUnknownNullCount; }
+      break;
+    }
+
+    case NullHandling::COMPUTED_PREALLOCATE: {
+      ARROW_ASSIGN_OR_RAISE(out_buffers[0], kernel_ctx.AllocateBitmap(out_length));
+      null_count = arrow::kUnknownNullCount;
+      break;
+    }
+
+    case NullHandling::COMPUTED_NO_PREALLOCATE:
+      null_count = arrow::kUnknownNullCount;
+      break;
+
+    case NullHandling::OUTPUT_NOT_NULL:
+      break;
+  }
+
+  const auto &out_type = *resolved_outtype.type;
+  if (    kernel->mem_allocation == MemAllocation::PREALLOCATE
+      and arrow::is_fixed_width(out_type.id())) {
+    int bit_width = static_cast<const arrow::FixedWidthType&>(out_type).bit_width();
+
+    if (bit_width == 1) {
+      ARROW_ASSIGN_OR_RAISE(out_buffers[1], kernel_ctx.AllocateBitmap(out_length));
+    }
+
+    else {
+      ARROW_ASSIGN_OR_RAISE(out_buffers[1], kernel_ctx.Allocate(out_length * bit_width / 8));
+    }
+  }
+
+  return arrow::ArrayData::Make(
+     resolved_outtype.GetSharedPtr()
+    ,out_length
+    ,std::move(out_buffers)
+    ,null_count
+  );
+}
+
+Result<Datum>
+ResolvedKernel::Call(const vector<Datum> &args) {
+  if (args.size() != called_types.size()) {
+    return Status::Invalid(
+      "Resolved for ", called_types.size(), " arguments, but called with ", args.size()
+    );
+  }
+
+  // >> Check (and, if needed, cast) each argument, then point the input span at it
+  input_span.length = args.empty() ? 0 : args[0].length();
+  for (size_t arg_ndx = 0; arg_ndx < args.size(); ++arg_ndx) {
+    const Datum &arg = args[arg_ndx];
+
+    if (not arg.is_array()) {
+      return Status::Invalid("ResolvedKernel only accepts arrays, got: ", arg.ToString());
+    }
+
+    if (not arg.type()->Equals(*called_types[arg_ndx].type)) {
+      return Status::TypeError(
+        "Resolved for ", called_types[arg_ndx].ToString(), ", but called with ", *arg.type()
+      );
+    }
+
+    if (arg.length() != input_span.length) {
+      return Status::Invalid("All arguments must have the same length");
+    }
+
+    if (arg_needs_cast[arg_ndx]) {
+      ARROW_ASSIGN_OR_RAISE(
+         call_args[arg_ndx]
+        ,arrow::compute::Cast(
+            arg
+           ,kernel_types[arg_ndx]
+           ,arrow::compute::CastOptions::Safe()
+           ,exec_ctx
+         )
+      );
+    }
+
+    else {
+      call_args[arg_ndx] = arg;
+    }
+
+    input_span.values[arg_ndx].SetArray(*call_args[arg_ndx].array());
+  }
+
+  // >> Run the kernel, either into preallocated buffers or letting it allocate
+  ARROW_ASSIGN_OR_RAISE(auto out_data, PreallocateOutput());
+
+  ExecResult out;
+  if (out_data->buffers[1] != nullptr) { out.array_span()->SetMembers(*out_data); }
+  else                                 { out.value = out_data;                    }
+
+  Status exec_status = kernel->exec(&kernel_ctx, input_span, &out);
+
+  // Don't hold on to the arguments between calls
+  for (auto &call_arg : call_args) { call_arg = Datum(); }
+  ARROW_RETURN_NOT_OK(exec_status);
+
+  if (out.is_array_data()) { return Datum(out.array_data()); }
+
+  out_data->null_count = out.array_span()->null_count;
+  return Datum(std::move(out_data));
+}
+
+
+// ------------------------------
+// Functions
+
+// >> Chunk-parallel execution
+/** Splits each chunk of `input_arg` into zero-copy slices of at most `max_task_rows`. */
+Result<arrow::ArrayVector>
+SplitIntoTasks(const Datum &input_arg, int64_t max_task_rows) {
+  if (max_task_rows <= 0) {
+    return Status::Invalid("max_task_rows must be positive, got ", max_task_rows);
+  }
+
+  arrow::ArrayVector input_chunks;
+  if      (input_arg.is_array())         { input_chunks = { input_arg.make_array() }; }
+  else if (input_arg.is_chunked_array()) { input_chunks = input_arg.chunks();         }
+  else {
+    return Status::Invalid("Expected an array or chunked array, got: ", input_arg.ToString());
+  }
+
+  arrow::ArrayVector task_slices;
+  for (const auto &input_chunk : input_chunks) {
+    int64_t chunk_len = input_chunk->length();
+
+    for (int64_t slice_start = 0; slice_start < chunk_len; slice_start += max_task_rows) {
+      task_slices.push_back(input_chunk->Slice(slice_start, max_task_rows));
+    }
+  }
+
+  return task_slices;
+}
+
+Result<Datum>
+CallFunctionChunkParallel( const string          &func_name
+                          ,const Datum           &input_arg
+                          ,const FunctionOptions *options
+                          ,ExecContext           *ctx
+                          ,int64_t                max_task_rows) {
+  if (ctx == nullptr) { ctx = default_exec_context(); }
+
+  ARROW_ASSIGN_OR_RAISE(auto task_slices, SplitIntoTasks(input_arg, max_task_rows));
+  int64_t task_count = static_cast<int64_t>(task_slices.size());
+
+  // >> Workers claim row ranges from a shared cursor until none are left
+  arrow::ArrayVector   out_chunks(task_count);
+  std::atomic<int64_t> next_task { 0 };
+
+  auto RunWorker = [&](int) -> Status {
+    std::unique_ptr<ResolvedKernel> resolved_fn;
+
+    for (int64_t task_ndx = next_task++; task_ndx < task_count; task_ndx = next_task++) {
+      if (resolved_fn == nullptr) {
+        ARROW_ASSIGN_OR_RAISE(
+           resolved_fn
+          ,ResolvedKernel::Make(func_name, { input_arg.type() }, options, ctx)
+        );
+      }
+
+      auto task_result = resolved_fn->Call({ Datum(task_slices[task_ndx]) });
+      if (not task_result.ok()) {
+        // Stop the other workers early; they finish the range they're on
+        next_task = task_count;
+        return task_result.status();
+      }
+
+      out_chunks[task_ndx] = task_result->make_array();
+    }
+
+    return Status::OK();
+  };
+
+  // A context without an executor (e.g. the default context) uses the CPU thread pool
+  auto thread_pool = ctx->executor();
+  if (thread_pool == nullptr) { thread_pool = arrow::internal::GetCpuThreadPool(); }
+
+  int worker_count = static_cast<int>(
+    std::min<int64_t>(task_count, ctx->use_threads() ? thread_pool->GetCapacity() : 1)
+  );
+
+  ARROW_RETURN_NOT_OK(
+    arrow::internal::OptionalParallelFor(
+       ctx->use_threads()
+      ,worker_count
+      ,RunWorker
+      ,thread_pool
+    )
+  );
+
+  // >> An empty input still needs the output type, so resolve it on this thread
+  if (task_count == 0) {
+    ARROW_ASSIGN_OR_RAISE(
+       auto resolved_fn
+      ,ResolvedKernel::Make(func_name, { input_arg.type() }, options, ctx)
+    );
+
+    return arrow::ChunkedArray::Make({}, resolved_fn->out_type().GetSharedPtr());
+  }
+
+  return arrow::ChunkedArray::Make(std::move(out_chunks));
+}
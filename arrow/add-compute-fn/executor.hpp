@@ -0,0 +1,97 @@
+#pragma once
+
+
+// ------------------------------
+// Dependencies
+
+#include "support.hpp"
+
+
+// ------------------------------
+// Classes
+
+// >> A function resolved ahead of time
+/**
+ * A compute function resolved once for a fixed list of input types, then called many
+ * times. `CallFunction` looks up the function by name, dispatches to a kernel, initializes
+ * the kernel's state and resolves the output type on every call. For small batches (e.g.
+ * batches coming off a stream), that can cost more than the kernel itself. `Make` does
+ * all of it once, so `Call` only checks its arguments, allocates the output and runs the
+ * kernel.
+ *
+ * Only scalar functions are supported, and `Call` only accepts arrays, in the order and of
+ * the types given to `Make`. If dispatch chose a kernel for other types (implicit casts,
+ * e.g. int8 to int32), each call casts its arguments first.
+ *
+ * A `ResolvedKernel` holds kernel state and reuses scratch space between calls, so it
+ * must not be called from more than one thread at a time. Use one per thread instead;
+ * they're cheap to make.
+ */
+class ResolvedKernel {
+  public:
+    static Result<std::unique_ptr<ResolvedKernel>>
+    Make( const string            &func_name
+         ,const vector<TypeHolder> &in_types
+         ,const FunctionOptions   *options = NULLPTR
+         ,ExecContext             *ctx     = NULLPTR);
+
+    ResolvedKernel(const ResolvedKernel&)            = delete;
+    ResolvedKernel& operator=(const ResolvedKernel&) = delete;
+
+    /** Runs the resolved kernel on `args` (arrays of equal length). */
+    Result<Datum>
+    Call(const vector<Datum> &args);
+
+    const TypeHolder&
+    out_type() const { return resolved_outtype; }
+
+  private:
+    ResolvedKernel(ExecContext *ctx, const ScalarKernel *kernel);
+
+    Result<std::shared_ptr<arrow::ArrayData>>
+    PreallocateOutput();
+
+    Result<shared_ptr<arrow::Buffer>>
+    IntersectValidity();
+
+    ExecContext                  *exec_ctx;
+    const ScalarKernel           *kernel;
+    KernelContext                 kernel_ctx;
+    std::unique_ptr<KernelState>  kernel_state;
+
+    vector<TypeHolder>            called_types;
+    vector<TypeHolder>            kernel_types;
+    vector<bool>                  arg_needs_cast;
+    TypeHolder                    resolved_outtype;
+
+    // reused by each call, so that steady-state calls don't reallocate them
+    vector<Datum>                 call_args;
+    ExecSpan                      input_span;
+};
+
+
+// ------------------------------
+// Functions
+
+// >> Chunk-parallel execution
+/**
+ * Calls the scalar function `func_name` on `input_arg` (a chunked array or an array),
+ * spreading the work over `ctx`'s executor (the CPU thread pool, by default). Each chunk
+ * is split into row ranges of at most `max_task_rows`, so a few large chunks still spread
+ * across threads.
+ *
+ * One worker is started per thread; each takes the next row range from a shared atomic
+ * cursor until none are left, so a worker that finishes early picks up the remaining
+ * work instead of idling. Each worker resolves the function once (see `ResolvedKernel`).
+ *
+ * The output has one chunk per row range, in input order. When `ctx->use_threads()` is
+ * false, the ranges are computed on the calling thread. The calling thread blocks until
+ * every range is done, so this must not be called from a task on the same thread pool.
+ */
+ARROW_EXPORT
+Result<Datum>
+CallFunctionChunkParallel( const string          &func_name
+                          ,const Datum           &input_arg
+                          ,const FunctionOptions *options       = NULLPTR
+                          ,ExecContext           *ctx           = NULLPTR
+                          ,int64_t                max_task_rows = 1 << 16);
@@ -0,0 +1,130 @@
+// ------------------------------
+// Dependencies
+
+#include "fusion.hpp"
+
+
+// ------------------------------
+// Macros and aliases
+
+// >> Names of the registered functions, which their kernels are also traced under
+constexpr char abs_log1p_name[]            = "abs_log1p";
+constexpr char abs_log1p_hash_name[]       = "abs_log1p_hash";
+constexpr char abs_log1p_scale_hash_name[] = "abs_log1p_scale_hash";
+
+// >> Chains of ops for the registered functions
+using AbsLog1p = Fused<
+   Step<AbsoluteValueOp>
+  ,Step<Log1p, double>
+>;
+
+template <typename InCType>
+using AbsLog1pExec = FusedUnary<InCType, AbsLog1p, abs_log1p_name>;
+
+template <typename InCType>
+using AbsLog1pHashExec = FusedHash<InCType, AbsLog1p, abs_log1p_hash_name>;
+
+// abs -> log1p -> scale (by 1000) -> hash
+using AbsLog1pScale = Fused<
+   AbsLog1p
+  ,Step<Scale<std::kilo>>
+>;
+
+template <typename InCType>
+using AbsLog1pScaleHashExec = FusedHash<InCType, AbsLog1pScale, abs_log1p_scale_hash_name>;
+
+
+// ------------------------------
+// Named Functions
+
+//  |> documentation
+const FunctionDoc abs_log1p_doc {
+   "Calculate log1p(abs(x)) element-wise, in a single pass"
+  ,(
+     "Equivalent to calling 'abs' and then 'log1p', without materializing the\n"
+     "intermediate array. Integer inputs wrap around on overflow, like 'abs'."
+   )
+  ,{ "x" }
+};
+
+const FunctionDoc abs_log1p_hash_doc {
+   "Hash log1p(abs(x)) element-wise, in a single pass"
+  ,(
+     "Equivalent to calling 'abs', 'log1p' and then 'named_scalar_fn', without\n"
+     "materializing either intermediate array. Null inputs give null outputs."
+   )
+  ,{ "x" }
+};
+
+const FunctionDoc abs_log1p_scale_hash_doc {
+   "Hash 1000 * log1p(abs(x)) element-wise, in a single pass"
+  ,(
+     "Equivalent to calling 'abs', 'log1p', 'multiply' (by 1000.0) and then\n"
+     "'named_scalar_fn', without materializing any intermediate array. Null\n"
+     "inputs give null outputs."
+   )
+  ,{ "x" }
+};
+
+
+// >> Kernel registration
+/**
+ * Adds a kernel to `fused_fn` for each numeric type, using `ExecTemplate<CType>::Exec`.
+ * This is the same mapping from arrow types to C types as `AddAbsoluteValueKernels`.
+ */
+template <template <typename> class ExecTemplate>
+void
+AddFusedKernels(ScalarFunction *fused_fn, OutputType out_type) {
+  for (const auto &numeric_type : NumericTypes()) {
+    ArrayKernelExec kernel_exec;
+
+    switch (numeric_type->id()) {
+      case arrow::Type::INT8  : kernel_exec = ExecTemplate<int8_t>::Exec  ; break;
+      case arrow::Type::INT16 : kernel_exec = ExecTemplate<int16_t>::Exec ; break;
+      case arrow::Type::INT32 : kernel_exec = ExecTemplate<int32_t>::Exec ; break;
+      case arrow::Type::INT64 : kernel_exec = ExecTemplate<int64_t>::Exec ; break;
+      case arrow::Type::UINT8 : kernel_exec = ExecTemplate<uint8_t>::Exec ; break;
+      case arrow::Type::UINT16: kernel_exec = ExecTemplate<uint16_t>::Exec; break;
+      case arrow::Type::UINT32: kernel_exec = ExecTemplate<uint32_t>::Exec; break;
+      case arrow::Type::UINT64: kernel_exec = ExecTemplate<uint64_t>::Exec; break;
+      case arrow::Type::FLOAT : kernel_exec = ExecTemplate<float>::Exec   ; break;
+      case arrow::Type::DOUBLE: kernel_exec = ExecTemplate<double>::Exec  ; break;
+
+      // e.g. half floats, which have no native C type
+      default: continue;
+    }
+
+    DCHECK_OK(fused_fn->AddKernel({ InputType(numeric_type) }, out_type, kernel_exec));
+  }
+}
+
+
+// ------------------------------
+// Registration
+
+void
+RegisterFusedFunctions(FunctionRegistry *registry) {
+  auto fn_abslog1p = std::make_shared<ScalarFunction>(
+     abs_log1p_name
+    ,Arity::Unary()
+    ,abs_log1p_doc
+  );
+  AddFusedKernels<AbsLog1pExec>(fn_abslog1p.get(), arrow::float64());
+  DCHECK_OK(registry->AddFunction(std::move(fn_abslog1p)));
+
+  auto fn_abslog1p_hash = std::make_shared<ScalarFunction>(
+     abs_log1p_hash_name
+    ,Arity::Unary()
+    ,abs_log1p_hash_doc
+  );
+  AddFusedKernels<AbsLog1pHashExec>(fn_abslog1p_hash.get(), arrow::uint32());
+  DCHECK_OK(registry->AddFunction(std::move(fn_abslog1p_hash)));
+
+  auto fn_abslog1p_scale_hash = std::make_shared<ScalarFunction>(
+     abs_log1p_scale_hash_name
+    ,Arity::Unary()
+    ,abs_log1p_scale_hash_doc
+  );
+  AddFusedKernels<AbsLog1pScaleHashExec>(fn_abslog1p_scale_hash.get(), arrow::uint32());
+  DCHECK_OK(registry->AddFunction(std::move(fn_abslog1p_scale_hash)));
+}
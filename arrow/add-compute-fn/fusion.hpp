@@ -0,0 +1,244 @@
+#pragma once
+
+
+// ------------------------------
+// Dependencies
+
+#include "example.hpp"
+
+#include <cmath>
+#include <ratio>
+#include <arrow/util/bit_run_reader.h>
+
+
+// ------------------------------
+// Macros and aliases
+
+// >> Names for ops that share a name with a function
+//    The ops and the "ergonomic" functions in "example.hpp" have the same names, and a
+//    function hides a struct of the same name, so ops need an elaborated name here.
+using AbsoluteValueOp        = struct AbsoluteValue;
+using AbsoluteValueCheckedOp = struct AbsoluteValueChecked;
+
+
+// ------------------------------
+// Classes
+
+// >> More elementwise ops, in the same shape as those in "example.hpp"
+
+/** Computes log(1 + x) in floating point. `T` should be a floating point type. */
+struct Log1p {
+  template <typename T, typename Arg>
+  static enable_if_floating_point<T>
+  Call(KernelContext*, Arg arg, Status*) {
+    return std::log1p(static_cast<T>(arg));
+  }
+};
+
+/** Multiplies by the compile-time constant `Ratio` (a `std::ratio`). */
+template <typename Ratio>
+struct Scale {
+  template <typename T, typename Arg>
+  static constexpr T
+  Call(KernelContext*, Arg arg, Status*) {
+    return static_cast<T>(arg) * static_cast<T>(Ratio::num) / static_cast<T>(Ratio::den);
+  }
+};
+
+
+// >> Composition of ops
+/**
+ * One step in a chain of fused ops: applies `Op` and produces an `OutT`. By default
+ * (`void`), a step produces the same type that it's given, so the chain's types only
+ * need to be spelled out where they change (e.g. integers to doubles at `Log1p`).
+ */
+template <typename Op, typename OutT = void>
+struct Step {
+  template <typename Arg>
+  using out_type = std::conditional_t<std::is_void<OutT>::value, Arg, OutT>;
+
+  template <typename Arg>
+  static constexpr out_type<Arg>
+  Apply(KernelContext *ctx, Arg arg, Status *st) {
+    return Op::template Call<out_type<Arg>, Arg>(ctx, arg, st);
+  }
+};
+
+/**
+ * A chain of `Step`s that the compiler inlines into a single op, so a kernel applies the
+ * whole chain to each value while it's in a register. This replaces a sequence of
+ * `CallFunction`s, which each read and write a full-length array.
+ *
+ * `Fused` is an op itself (it has `Call<T, Arg>`), so chains can be nested and passed
+ * wherever an op is expected.
+ */
+template <typename... Steps>
+struct Fused;
+
+template <>
+struct Fused<> {
+  template <typename Arg>
+  using out_type = Arg;
+
+  template <typename Arg>
+  static constexpr Arg
+  Apply(KernelContext*, Arg arg, Status*) { return arg; }
+};
+
+template <typename FirstStep, typename... OtherSteps>
+struct Fused<FirstStep, OtherSteps...> {
+  template <typename Arg>
+  using out_type = typename Fused<OtherSteps...>::template out_type<
+    typename FirstStep::template out_type<Arg>
+  >;
+
+  template <typename Arg>
+  static constexpr out_type<Arg>
+  Apply(KernelContext *ctx, Arg arg, Status *st) {
+    return Fused<OtherSteps...>::Apply(ctx, FirstStep::Apply(ctx, arg, st), st);
+  }
+
+  template <typename T, typename Arg>
+  static constexpr T
+  Call(KernelContext *ctx, Arg arg, Status *st) {
+    return static_cast<T>(Apply(ctx, arg, st));
+  }
+};
+
+
+// >> Kernels for a fused chain
+/**
+ * A kernel that applies `Chain` to each valid value of a numeric array in one pass. The
+ * output is preallocated and its validity is the input's (`INTERSECTION`).
+ *
+ * Null slots are skipped, so that a checked op can't report an error for a value that
+ * isn't there. Calls are traced under `kTraceName`, the registered function's name.
+ */
+template <typename InCType, typename Chain, const char *kTraceName>
+struct FusedUnary {
+  using OutCType = typename Chain::template out_type<InCType>;
+
+  static Status
+  Exec(KernelContext *ctx, const ExecSpan &input_arg, ExecResult *out) {
+    RECIPE_TRACE_KERNEL(kTraceName, input_arg.length);
+    const ArraySpan &input_arr  = input_arg[0].array;
+    const InCType   *input_vals = input_arr.GetValues<InCType>(1);
+    OutCType        *out_vals   = out->array_span()->GetValues<OutCType>(1);
+
+    Status st;
+    ApplyToValidRuns(
+       input_arr
+      ,[&](int64_t run_start, int64_t run_len) {
+         for (int64_t ndx = run_start; ndx < run_start + run_len; ++ndx) {
+           out_vals[ndx] = Chain::Apply(ctx, input_vals[ndx], &st);
+         }
+       }
+    );
+
+    return st;
+  }
+
+  /** Calls `apply_fn(start, length)` for each run of valid slots in `input_arr`. */
+  template <typename ApplyFn>
+  static void
+  ApplyToValidRuns(const ArraySpan &input_arr, ApplyFn &&apply_fn) {
+    if (input_arr.GetNullCount() == 0) {
+      apply_fn(0, input_arr.length);
+      return;
+    }
+
+    arrow::internal::VisitSetBitRunsVoid(
+       input_arr.buffers[0].data
+      ,input_arr.offset
+      ,input_arr.length
+      ,std::forward<ApplyFn>(apply_fn)
+    );
+  }
+};
+
+/**
+ * A kernel that applies `Chain` and then hashes the result with `Hashing32`, so the
+ * transformed values never exist as a full-length array. Values are transformed into a
+ * minibatch-sized tile on the thread's hash stack, and each tile is hashed while it's
+ * still in cache.
+ *
+ * The hashes match "named_scalar_fn" applied to the materialized output of `Chain`. Null
+ * slots are transformed along with valid ones (their values are never hashed, and their
+ * outputs are null), so `Chain` should only contain ops that can't fail. Calls are
+ * traced under `kTraceName`, as for `FusedUnary`.
+ */
+template <typename InCType, typename Chain, const char *kTraceName>
+struct FusedHash {
+  using OutCType = typename Chain::template out_type<InCType>;
+
+  static constexpr uint32_t max_batchsize  = MiniBatch::kMiniBatchLength;
+  static constexpr int64_t  tile_stacksize = (
+    MiniBatch::kMiniBatchLength * sizeof(OutCType) + 80
+  );
+
+  static Status
+  Exec(KernelContext *ctx, const ExecSpan &input_arg, ExecResult *out) {
+    RECIPE_TRACE_KERNEL(kTraceName, input_arg.length);
+    const ArraySpan &input_arr    = input_arg[0].array;
+    const InCType   *input_vals   = input_arr.GetValues<InCType>(1);
+    uint32_t        *hash_results = out->array_span()->GetValues<uint32_t>(1);
+
+    // >> Scratch memory for the tile and for the hash function
+    ARROW_ASSIGN_OR_RAISE(
+       TempVectorStack *stack_memallocator
+      ,ThreadLocalHashStack(hash32_stacksize + tile_stacksize)
+    );
+
+    TempVectorHolder<OutCType> tile_holder(stack_memallocator, max_batchsize);
+    OutCType *tile_vals = tile_holder.mutable_data();
+
+    LightContext hash_ctx;
+    hash_ctx.hardware_flags = ctx->exec_context()->cpu_info()->hardware_flags();
+    hash_ctx.stack          = stack_memallocator;
+
+    // >> Transform and hash one tile at a time
+    const uint8_t *input_validity = input_arr.buffers[0].data;
+    if (input_arr.GetNullCount() == 0) { input_validity = nullptr; }
+
+    Status                 st;
+    vector<KeyColumnArray> hash_cols(1);
+    for (int64_t tile_start = 0; tile_start < input_arr.length; tile_start += max_batchsize) {
+      int64_t tile_len = std::min<int64_t>(max_batchsize, input_arr.length - tile_start);
+
+      for (int64_t ndx = 0; ndx < tile_len; ++ndx) {
+        tile_vals[ndx] = Chain::Apply(ctx, input_vals[tile_start + ndx], &st);
+      }
+      ARROW_RETURN_NOT_OK(st);
+
+      int64_t validity_bit = input_arr.offset + tile_start;
+      hash_cols[0] = KeyColumnArray(
+         KeyColumnMetadata(/*is_fixed_length=*/true, sizeof(OutCType))
+        ,tile_len
+        ,(input_validity == nullptr) ? nullptr : input_validity + (validity_bit / 8)
+        ,reinterpret_cast<const uint8_t*>(tile_vals)
+        ,/*var_length_buffer=*/nullptr
+        ,/*bit_offset_validity=*/static_cast<int>(validity_bit % 8)
+      );
+
+      Hashing32::HashMultiColumn(hash_cols, &hash_ctx, hash_results + tile_start);
+    }
+
+    return Status::OK();
+  }
+};
+
+
+// ------------------------------
+// Functions
+
+/**
+ * Registers functions that each run a fused chain of ops over numeric input:
+ *  - "abs_log1p"           : log1p(abs(x)), as float64
+ *  - "abs_log1p_hash"      : hash32(log1p(abs(x))), as uint32
+ *  - "abs_log1p_scale_hash": hash32(1000 * log1p(abs(x))), as uint32
+ *
+ * Null inputs give null outputs (`INTERSECTION`).
+ */
+ARROW_EXPORT
+void
+RegisterFusedFunctions(FunctionRegistry *registry);
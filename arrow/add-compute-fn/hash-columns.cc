@@ -0,0 +1,252 @@
+// ------------------------------
+// Dependencies
+
+#include "hash-columns.hpp"
+
+
+// ------------------------------
+// Options
+
+const FunctionOptionsType*
+GetHashColumnsOptionsType() {
+  static const RecipeOptionsType<HashColumnsOptions> options_type;
+  return &options_type;
+}
+
+HashColumnsOptions::HashColumnsOptions(int bit_width, uint64_t seed)
+  : FunctionOptions(GetHashColumnsOptionsType())
+   ,bit_width(bit_width)
+   ,seed(seed) {}
+
+string
+HashColumnsOptions::Describe() const {
+  return (
+      "HashColumnsOptions(bit_width=" + std::to_string(bit_width)
+    + ", seed="                       + std::to_string(seed)
+    + ")"
+  );
+}
+
+bool
+HashColumnsOptions::IsEqual(const HashColumnsOptions &other) const {
+  return bit_width == other.bit_width and seed == other.seed;
+}
+
+
+// ------------------------------
+// Structs and Classes
+
+// >> Documentation for a compute function
+const FunctionDoc hash_columns_doc {
+   "Variadic function that calculates one hash for each row across all arguments"
+  ,(
+     "Every argument is a key column, and each row's key columns are combined into\n"
+     "a single hash. Use HashColumnsOptions to choose 32-bit or 64-bit hashes."
+   )
+  ,{ "*key_columns" }
+  ,"HashColumnsOptions"
+};
+
+
+// >> Hash width traits
+/**
+ * Associates each hash function with the type of hash it produces, the scratch memory it
+ * needs, and a finalizer to mix a seed into a hash (the `fmix` steps from MurmurHash3).
+ */
+template <typename Hasher>
+struct HashTraits;
+
+template <>
+struct HashTraits<Hashing32> {
+  using hash_type = uint32_t;
+
+  static constexpr int64_t stacksize = hash32_stacksize;
+
+  static uint32_t
+  MixSeed(uint32_t hash, uint64_t seed) {
+    hash ^= static_cast<uint32_t>(seed);
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bU;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35U;
+    hash ^= hash >> 16;
+    return hash;
+  }
+};
+
+template <>
+struct HashTraits<Hashing64> {
+  using hash_type = uint64_t;
+
+  static constexpr int64_t stacksize = hash64_stacksize;
+
+  static uint64_t
+  MixSeed(uint64_t hash, uint64_t seed) {
+    hash ^= seed;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+};
+
+
+// >> Kernel implementations for a compute function
+struct HashColumns {
+
+  /**
+   * The output type depends on the options rather than the input types, so the kernel
+   * uses a resolver instead of a fixed `OutputType`.
+   */
+  static Result<TypeHolder>
+  ResolveOutput(KernelContext *ctx, const vector<TypeHolder>&) {
+    const auto &options = OptionsState<HashColumnsOptions>::Get(ctx);
+
+    switch (options.bit_width) {
+      case 32: return TypeHolder(arrow::uint32());
+      case 64: return TypeHolder(arrow::uint64());
+      default: break;
+    }
+
+    return Status::Invalid("hash_columns bit_width must be 32 or 64, got ", options.bit_width);
+  }
+
+  /**
+   * Hashes every row of `input_args` with `Hasher`, one minibatch at a time. Each
+   * minibatch of hashes is written into the preallocated output and, if a seed was given,
+   * mixed with the seed while it is still in cache.
+   */
+  template <typename Hasher>
+  static Status
+  HashRows(KernelContext *ctx, const ExecSpan &input_args, ExecResult *out, uint64_t seed) {
+    using hash_type   = typename HashTraits<Hasher>::hash_type;
+    using hash_traits = HashTraits<Hasher>;
+
+    // >> Prepare the key columns
+    vector<KeyColumnArray> key_cols;
+    key_cols.reserve(input_args.num_values());
+
+    for (int arg_ndx = 0; arg_ndx < input_args.num_values(); ++arg_ndx) {
+      if (not input_args[arg_ndx].is_array()) {
+        return Status::Invalid("hash_columns expects every argument to be an array");
+      }
+
+      const ArraySpan &key_arr = input_args[arg_ndx].array;
+      ARROW_ASSIGN_OR_RAISE(
+         KeyColumnArray key_col
+        ,ColumnArrayFromArrayData(key_arr.ToArrayData(), 0, key_arr.length)
+      );
+
+      key_cols.push_back(key_col);
+    }
+
+    // >> Prepare the hash function's context
+    ARROW_ASSIGN_OR_RAISE(
+       TempVectorStack *stack_memallocator
+      ,ThreadLocalHashStack(hash_traits::stacksize)
+    );
+
+    LightContext hash_ctx;
+    hash_ctx.hardware_flags = ctx->exec_context()->cpu_info()->hardware_flags();
+    hash_ctx.stack          = stack_memallocator;
+
+    // >> Hash each minibatch into the output
+    ArraySpan *out_arr      = out->array_span();
+    hash_type *hash_results = out_arr->GetValues<hash_type>(1);
+    int64_t    row_count    = input_args.length;
+
+    vector<KeyColumnArray> batch_cols(key_cols.size());
+    for (int64_t batch_start = 0; batch_start < row_count; batch_start += max_batchsize) {
+      int64_t    batch_len    = std::min<int64_t>(max_batchsize, row_count - batch_start);
+      hash_type *batch_hashes = hash_results + batch_start;
+
+      for (size_t col_ndx = 0; col_ndx < key_cols.size(); ++col_ndx) {
+        batch_cols[col_ndx] = key_cols[col_ndx].Slice(batch_start, batch_len);
+      }
+
+      Hasher::HashMultiColumn(batch_cols, &hash_ctx, batch_hashes);
+
+      if (seed != 0) {
+        for (int64_t row_ndx = 0; row_ndx < batch_len; ++row_ndx) {
+          batch_hashes[row_ndx] = hash_traits::MixSeed(batch_hashes[row_ndx], seed);
+        }
+      }
+    }
+
+    return Status::OK();
+  }
+
+  static Status
+  Exec(KernelContext *ctx, const ExecSpan &input_args, ExecResult *out) {
+    RECIPE_TRACE_KERNEL("hash_columns", input_args.length);
+    const auto &options = OptionsState<HashColumnsOptions>::Get(ctx);
+
+    if (options.bit_width == 64) {
+      return HashRows<Hashing64>(ctx, input_args, out, options.seed);
+    }
+
+    return HashRows<Hashing32>(ctx, input_args, out, options.seed);
+  }
+
+
+  static constexpr uint32_t max_batchsize = MiniBatch::kMiniBatchLength;
+};
+
+
+// ------------------------------
+// Functions
+
+// >> Function registration and kernel association
+/**
+ * "hash_columns" accepts any number of arguments (`Arity::VarArgs`), so its kernel has a
+ * varargs signature with a single `InputType` that every argument must match.
+ *
+ * Null keys are hashed like any other value (they take part in grouping and
+ * partitioning), so the kernel is registered with `OUTPUT_NOT_NULL` rather than the
+ * default, which would make a row's hash null if any key column were null.
+ */
+shared_ptr<ScalarFunction>
+RegisterHashColumnsKernels() {
+  static const HashColumnsOptions default_options = HashColumnsOptions::Defaults();
+
+  auto fn_hash_columns = std::make_shared<ScalarFunction>(
+     "hash_columns"
+    ,Arity::VarArgs(1)
+    ,hash_columns_doc
+    ,&default_options
+  );
+
+  ScalarKernel kernel {
+     KernelSignature::Make(
+        { InputType::Any() }
+       ,OutputType(HashColumns::ResolveOutput)
+       ,/*is_varargs=*/true
+     )
+    ,HashColumns::Exec
+    ,OptionsState<HashColumnsOptions>::Init
+  };
+
+  kernel.null_handling  = NullHandling::OUTPUT_NOT_NULL;
+  kernel.mem_allocation = MemAllocation::PREALLOCATE;
+  DCHECK_OK(fn_hash_columns->AddKernel(std::move(kernel)));
+
+  return fn_hash_columns;
+}
+
+
+void
+RegisterHashColumnsFn(FunctionRegistry *registry) {
+  auto scalar_fn = RegisterHashColumnsKernels();
+  DCHECK_OK(registry->AddFunction(std::move(scalar_fn)));
+}
+
+
+// >> Convenience functions
+Result<Datum>
+HashColumns( const vector<Datum>       &key_cols
+            ,const HashColumnsOptions &options
+            ,ExecContext              *ctx) {
+  return CallFunction("hash_columns", key_cols, &options, ctx);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+
+// ------------------------------
+// Dependencies
+
+#include "support.hpp"
+
+
+// ------------------------------
+// Classes
+
+// >> Options for a compute function
+/**
+ * Options for "hash_columns". The function computes one hash per row, combining every key
+ * column, and `bit_width` chooses between `Hashing32` (32) and `Hashing64` (64).
+ *
+ * A non-zero `seed` is mixed into each row's hash. Two stages that hash the same keys
+ * (e.g. partitioning, then grouping within a partition) should use different seeds, so
+ * that rows sharing a partition aren't also clustered into the same groups. Keys whose
+ * hashes collide still collide under every seed.
+ */
+class ARROW_EXPORT HashColumnsOptions : public FunctionOptions {
+  public:
+    explicit HashColumnsOptions(int bit_width = 32, uint64_t seed = 0);
+
+    static constexpr char kTypeName[] = "HashColumnsOptions";
+    static HashColumnsOptions Defaults() { return HashColumnsOptions(); }
+
+    string Describe()                                const;
+    bool   IsEqual(const HashColumnsOptions &other) const;
+
+    int      bit_width;
+    uint64_t seed;
+};
+
+
+// ------------------------------
+// Functions
+
+// >> Function registration and kernel association
+/** Registers "hash_columns", a variadic function that hashes rows across key columns. */
+ARROW_EXPORT
+void
+RegisterHashColumnsFn(FunctionRegistry *registry);
+
+
+// >> Convenience functions
+/** Invokes "hash_columns" on `key_cols`, which must all be arrays of the same length. */
+ARROW_EXPORT
+Result<Datum>
+HashColumns( const vector<Datum>       &key_cols
+            ,const HashColumnsOptions &options = HashColumnsOptions::Defaults()
+            ,ExecContext              *ctx     = NULLPTR);
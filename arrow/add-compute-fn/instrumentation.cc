@@ -0,0 +1,131 @@
+// ------------------------------
+// Dependencies
+
+#include "instrumentation.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+
+// ------------------------------
+// Structs and Classes
+
+/**
+ * Counters for each kernel a thread has called. The owning thread looks up and updates
+ * its counters without locking; `table_mutex` only guards adding a kernel to the table
+ * against a snapshot that is reading it.
+ */
+struct ThreadCounterTable {
+  ThreadCounterTable();
+  ~ThreadCounterTable();
+
+  std::mutex                                                           table_mutex;
+  std::unordered_map<std::string, std::unique_ptr<KernelCounterCells>> by_kernel;
+};
+
+/**
+ * Every live thread's table, plus the totals of threads that have exited. A thread folds
+ * its table into `retired` as it exits, so that counts aren't lost when a thread pool
+ * shrinks.
+ */
+struct CounterRegistry {
+  std::mutex                            registry_mutex;
+  std::vector<ThreadCounterTable*>      live_tables;
+  std::map<std::string, KernelCounters> retired;
+};
+
+/** Intentionally leaked: thread-local tables may be destroyed after static objects. */
+CounterRegistry&
+GetCounterRegistry() {
+  static CounterRegistry *counter_registry = new CounterRegistry;
+  return *counter_registry;
+}
+
+void
+AddCounters(KernelCounters *totals, const KernelCounterCells &cells) {
+  totals->calls           += cells.calls.load(std::memory_order_relaxed);
+  totals->rows            += cells.rows.load(std::memory_order_relaxed);
+  totals->bytes_allocated += cells.bytes_allocated.load(std::memory_order_relaxed);
+  totals->nanos           += cells.nanos.load(std::memory_order_relaxed);
+}
+
+ThreadCounterTable::ThreadCounterTable() {
+  auto &counter_registry = GetCounterRegistry();
+
+  std::lock_guard<std::mutex> registry_lock(counter_registry.registry_mutex);
+  counter_registry.live_tables.push_back(this);
+}
+
+ThreadCounterTable::~ThreadCounterTable() {
+  auto &counter_registry = GetCounterRegistry();
+
+  std::lock_guard<std::mutex> registry_lock(counter_registry.registry_mutex);
+  for (const auto &kernel_counters : by_kernel) {
+    AddCounters(&counter_registry.retired[kernel_counters.first], *kernel_counters.second);
+  }
+
+  auto &live_tables = counter_registry.live_tables;
+  live_tables.erase(std::find(live_tables.begin(), live_tables.end(), this));
+}
+
+
+// ------------------------------
+// Functions
+
+KernelCounterCells*
+ThreadKernelCounters(const char *kernel_name) {
+  thread_local ThreadCounterTable thread_table;
+
+  std::lock_guard<std::mutex> table_lock(thread_table.table_mutex);
+  auto &kernel_counters = thread_table.by_kernel[kernel_name];
+  if (kernel_counters == nullptr) {
+    kernel_counters = std::make_unique<KernelCounterCells>();
+  }
+
+  return kernel_counters.get();
+}
+
+std::map<std::string, KernelCounters>
+KernelCountersSnapshot() {
+  auto &counter_registry = GetCounterRegistry();
+
+  std::lock_guard<std::mutex> registry_lock(counter_registry.registry_mutex);
+  std::map<std::string, KernelCounters> totals = counter_registry.retired;
+
+  for (auto thread_table : counter_registry.live_tables) {
+    std::lock_guard<std::mutex> table_lock(thread_table->table_mutex);
+
+    for (const auto &kernel_counters : thread_table->by_kernel) {
+      AddCounters(&totals[kernel_counters.first], *kernel_counters.second);
+    }
+  }
+
+  return totals;
+}
+
+void
+DumpKernelCounters(std::ostream &out_stream) {
+  for (const auto &kernel_counters : KernelCountersSnapshot()) {
+    const auto &counters = kernel_counters.second;
+
+    out_stream << kernel_counters.first
+               << "\tcalls: "           << counters.calls
+               << "\trows: "            << counters.rows
+               << "\tbytes_allocated: " << counters.bytes_allocated
+               << "\tns: "              << counters.nanos
+               << std::endl
+    ;
+  }
+}
+
+void
+DumpKernelCountersAtExit() {
+  static std::once_flag registered;
+  std::call_once(registered, []() {
+    std::atexit([]() { DumpKernelCounters(std::cerr); });
+  });
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+
+// ------------------------------
+// Dependencies
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+
+
+// ------------------------------
+// Macros and aliases
+
+// >> Kernel tracing
+/**
+ * Kernels are traced only when this is non-zero (meson: `-Dkernel_tracing=true`). By
+ * default, the macros below expand to nothing, so their arguments aren't evaluated and
+ * kernels pay nothing for them.
+ *
+ * When enabled, each kernel call adds to counters that belong to the calling thread, so
+ * counting needs no locks or atomic read-modify-writes. No strings are formatted until
+ * the counters are read (see `KernelCountersSnapshot`).
+ *
+ * Usage, at the top of a kernel's `Exec`:
+ *
+ *    RECIPE_TRACE_KERNEL("named_scalar_fn", input_arg.length);
+ *    ...
+ *    RECIPE_TRACE_ALLOCATED(value_hashbuf->size());
+ */
+#ifndef RECIPE_KERNEL_TRACING
+  #define RECIPE_KERNEL_TRACING 0
+#endif
+
+#if RECIPE_KERNEL_TRACING
+  #define RECIPE_TRACE_KERNEL(kernel_name, row_count)                               \
+    static thread_local KernelCounterCells *recipe_trace_counters = (               \
+      ThreadKernelCounters(kernel_name)                                             \
+    );                                                                              \
+    KernelTraceScope recipe_trace_scope(recipe_trace_counters, (row_count))
+
+  #define RECIPE_TRACE_ALLOCATED(byte_count)                                        \
+    recipe_trace_scope.AddAllocated(byte_count)
+#else
+  #define RECIPE_TRACE_KERNEL(kernel_name, row_count) static_cast<void>(0)
+  #define RECIPE_TRACE_ALLOCATED(byte_count)          static_cast<void>(0)
+#endif
+
+
+// ------------------------------
+// Structs and Classes
+
+/** Totals for one kernel, as returned by `KernelCountersSnapshot`. */
+struct KernelCounters {
+  int64_t calls           { 0 };
+  int64_t rows            { 0 };
+  int64_t bytes_allocated { 0 };
+  int64_t nanos           { 0 };
+};
+
+/**
+ * One thread's totals for one kernel. Only the owning thread writes them, so an update is
+ * a relaxed load and store rather than a locked add; they're atomic only so that other
+ * threads can read them for a snapshot.
+ */
+struct KernelCounterCells {
+  std::atomic<int64_t> calls           { 0 };
+  std::atomic<int64_t> rows            { 0 };
+  std::atomic<int64_t> bytes_allocated { 0 };
+  std::atomic<int64_t> nanos           { 0 };
+
+  static void
+  Add(std::atomic<int64_t> &cell, int64_t val) {
+    cell.store(cell.load(std::memory_order_relaxed) + val, std::memory_order_relaxed);
+  }
+};
+
+/**
+ * Counts one kernel call: rows when constructed, and elapsed time when destroyed (so every
+ * return path is timed). Only used through `RECIPE_TRACE_KERNEL`.
+ */
+class KernelTraceScope {
+  public:
+    KernelTraceScope(KernelCounterCells *counters, int64_t row_count)
+      : counters(counters), tstart(std::chrono::steady_clock::now()) {
+      KernelCounterCells::Add(counters->calls, 1);
+      KernelCounterCells::Add(counters->rows , row_count);
+    }
+
+    ~KernelTraceScope() {
+      auto elapsed = std::chrono::steady_clock::now() - tstart;
+      KernelCounterCells::Add(
+         counters->nanos
+        ,std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()
+      );
+    }
+
+    void
+    AddAllocated(int64_t byte_count) {
+      KernelCounterCells::Add(counters->bytes_allocated, byte_count);
+    }
+
+  private:
+    KernelCounterCells                    *counters;
+    std::chrono::steady_clock::time_point  tstart;
+};
+
+
+// ------------------------------
+// Functions
+
+/**
+ * Returns the calling thread's counters for `kernel_name`, creating them if needed. The
+ * pointer stays valid for the life of the thread, so `RECIPE_TRACE_KERNEL` looks it up
+ * once per thread and call site.
+ */
+KernelCounterCells*
+ThreadKernelCounters(const char *kernel_name);
+
+/**
+ * Returns each kernel's counters, summed over all threads (including threads that have
+ * exited). Counters are read while other threads may still be adding to them, so a
+ * snapshot taken during execution can be slightly behind. Empty unless tracing is enabled.
+ */
+std::map<std::string, KernelCounters>
+KernelCountersSnapshot();
+
+/** Writes `KernelCountersSnapshot()` to `out_stream`, one line per kernel. */
+void
+DumpKernelCounters(std::ostream &out_stream);
+
+/** Calls `DumpKernelCounters(std::cerr)` when the program exits. */
+void
+DumpKernelCountersAtExit();
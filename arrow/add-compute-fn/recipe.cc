@@ -36,66 +36,291 @@ const FunctionDoc named_scalar_fn_doc {
  */
 struct NamedScalarFn {
 
+  /**
+   * Hashes every row of `hash_input` into `hash_results`, one minibatch at a time. This is
+   * shared by each kernel below, which differ only in which values they hash and how they
+   * map those hashes to output rows.
+   */
+  static Status
+  HashValues(KernelContext *ctx, const ArraySpan &hash_input, uint32_t *hash_results) {
+    // >> Get the stack-based memory allocator for this thread
+    // NOTE: the stack is reused across calls, so steady-state hashing doesn't allocate
+    ARROW_ASSIGN_OR_RAISE(
+       TempVectorStack *stack_memallocator
+      ,ThreadLocalHashStack(hash32_stacksize)
+    );
+
+    // >> Prepare input data structure for propagation to hash function
+    // NOTE: "start row index" and "row count" can potentially be options in the future
+    int64_t hash_startrow = 0;
+    int64_t hash_rowcount = hash_input.length;
+    ARROW_ASSIGN_OR_RAISE(
+       KeyColumnArray input_keycol
+      ,ColumnArrayFromArrayData(hash_input.ToArrayData(), hash_startrow, hash_rowcount)
+    );
+
+    // >> Call hashing function one minibatch at a time
+    LightContext hash_ctx;
+    hash_ctx.hardware_flags = ctx->exec_context()->cpu_info()->hardware_flags();
+    hash_ctx.stack          = stack_memallocator;
+
+    vector<KeyColumnArray> hash_cols(1);
+    for (int64_t batch_start = 0; batch_start < hash_rowcount; batch_start += max_batchsize) {
+      int64_t batch_len = std::min<int64_t>(max_batchsize, hash_rowcount - batch_start);
+
+      hash_cols[0] = input_keycol.Slice(batch_start, batch_len);
+      Hashing32::HashMultiColumn(hash_cols, &hash_ctx, hash_results + batch_start);
+    }
+
+    return Status::OK();
+  }
+
   /**
    * A kernel implementation that expects a single array as input, and outputs an array of
    * uint32 values. We write this implementation knowing what function we want to
    * associate it with ("NamedScalarFn"), but that association is made later (see
    * `RegisterScalarFnKernels()` below).
+   *
+   * The kernel is registered with the default memory allocation (`PREALLOCATE`), so the
+   * compute framework hands us an output `ArraySpan` whose data buffer already has room
+   * for one uint32 per input row. `Hashing32` writes into that buffer directly.
    */
   static Status
   Exec(KernelContext *ctx, const ExecSpan &input_arg, ExecResult *out) {
-    ARROW_LOG(INFO) << "Calling kernel 'NamedScalarFn'";
+    RECIPE_TRACE_KERNEL("named_scalar_fn", input_arg.length);
     if (input_arg.num_values() != 1 or not input_arg[0].is_array()) {
       return Status::Invalid("Unsupported argument types or shape");
     }
 
-    // >> Initialize stack-based memory allocator with an allocator and memory size
-    ARROW_LOG(INFO) << "Accessing input data";
-
-    TempVectorStack stack_memallocator;
-    auto            input_dtype_width = input_arg[0].type()->bit_width();
-    if (input_dtype_width > 0) {
-      ARROW_RETURN_NOT_OK(
-        stack_memallocator.Init(
-           ctx->exec_context()->memory_pool()
-          ,input_dtype_width * max_batchsize
-        )
+    ArraySpan *out_arr      = out->array_span();
+    uint32_t  *hash_results = out_arr->GetValues<uint32_t>(1);
+    ARROW_RETURN_NOT_OK(HashValues(ctx, input_arg[0].array, hash_results));
+
+    return Status::OK();
+  }
+
+
+  // >> Dictionary-encoded input
+  /**
+   * Copies the hash of each row's dictionary value to the output. Rows with a null index
+   * may hold any index value, so they are skipped rather than dereferenced.
+   */
+  template <typename IndexType>
+  static void
+  GatherHashes( const ArraySpan &dict_input
+               ,const uint32_t  *value_hashes
+               ,uint32_t        *hash_results) {
+    const IndexType *indices = dict_input.GetValues<IndexType>(1);
+
+    if (dict_input.GetNullCount() == 0) {
+      for (int64_t row_ndx = 0; row_ndx < dict_input.length; ++row_ndx) {
+        hash_results[row_ndx] = value_hashes[indices[row_ndx]];
+      }
+
+      return;
+    }
+
+    for (int64_t row_ndx = 0; row_ndx < dict_input.length; ++row_ndx) {
+      hash_results[row_ndx] = (
+          dict_input.IsValid(row_ndx)
+        ? value_hashes[indices[row_ndx]]
+        : 0
       );
     }
+  }
 
-    // >> Prepare input data structure for propagation to hash function
-    // NOTE: "start row index" and "row count" can potentially be options in the future
-    ARROW_LOG(INFO) << "Accessing input data";
+  /**
+   * Writes the output validity for a dictionary-encoded input. A row is null if its index
+   * is null or if the dictionary value it points to is null.
+   */
+  template <typename IndexType>
+  static void
+  GatherValidity(const ArraySpan &dict_input, ArraySpan *out_arr) {
+    const ArraySpan &dict_values  = dict_input.dictionary();
+    const IndexType *indices      = dict_input.GetValues<IndexType>(1);
+    uint8_t         *out_validity = out_arr->buffers[0].data;
+
+    if (dict_input.GetNullCount() == 0 and dict_values.GetNullCount() == 0) {
+      arrow::bit_util::SetBitsTo(out_validity, out_arr->offset, out_arr->length, true);
+      out_arr->null_count = 0;
+      return;
+    }
+
+    int64_t null_count = 0;
+    for (int64_t row_ndx = 0; row_ndx < dict_input.length; ++row_ndx) {
+      bool is_valid = (
+            dict_input.IsValid(row_ndx)
+        and dict_values.IsValid(indices[row_ndx])
+      );
+
+      arrow::bit_util::SetBitTo(out_validity, out_arr->offset + row_ndx, is_valid);
+      null_count += not is_valid;
+    }
+
+    out_arr->null_count = null_count;
+  }
+
+  template <typename IndexType>
+  static void
+  GatherDictionary( const ArraySpan &dict_input
+                   ,const uint32_t  *value_hashes
+                   ,ArraySpan       *out_arr) {
+    GatherHashes<IndexType>(dict_input, value_hashes, out_arr->GetValues<uint32_t>(1));
+    GatherValidity<IndexType>(dict_input, out_arr);
+  }
 
-    ArraySpan hash_input    = input_arg[0].array;
-    int64_t   hash_startrow = 0;
-    int64_t   hash_rowcount = hash_input.length;
+  /**
+   * A kernel for dictionary-encoded input. Each distinct dictionary value is hashed once,
+   * then each row's hash is gathered through its index. The result is identical to
+   * hashing the decoded array, but the hashing work scales with the dictionary length
+   * instead of the row count.
+   *
+   * Validity depends on the dictionary as well as the indices, so this kernel is
+   * registered with `COMPUTED_PREALLOCATE` and writes the output validity itself.
+   */
+  static Status
+  ExecDictionary(KernelContext *ctx, const ExecSpan &input_arg, ExecResult *out) {
+    RECIPE_TRACE_KERNEL("named_scalar_fn:dictionary", input_arg.length);
+    if (input_arg.num_values() != 1 or not input_arg[0].is_array()) {
+      return Status::Invalid("Unsupported argument types or shape");
+    }
+
+    const ArraySpan &dict_input  = input_arg[0].array;
+    const ArraySpan &dict_values = dict_input.dictionary();
+
+    // >> Hash each distinct value once
     ARROW_ASSIGN_OR_RAISE(
-       KeyColumnArray input_keycol
-      ,ColumnArrayFromArrayData(hash_input.ToArrayData(), hash_startrow, hash_rowcount)
+       auto value_hashbuf
+      ,ctx->Allocate(dict_values.length * sizeof(uint32_t))
     );
+    RECIPE_TRACE_ALLOCATED(value_hashbuf->size());
+
+    auto value_hashes = reinterpret_cast<uint32_t*>(value_hashbuf->mutable_data());
+    ARROW_RETURN_NOT_OK(HashValues(ctx, dict_values, value_hashes));
+
+    // >> Map value hashes to rows
+    ArraySpan  *out_arr   = out->array_span();
+    const auto &dict_type = static_cast<const arrow::DictionaryType&>(*dict_input.type);
+
+    switch (dict_type.index_type()->id()) {
+      case arrow::Type::INT8:
+        GatherDictionary<int8_t>  (dict_input, value_hashes, out_arr); break;
+      case arrow::Type::UINT8:
+        GatherDictionary<uint8_t> (dict_input, value_hashes, out_arr); break;
+      case arrow::Type::INT16:
+        GatherDictionary<int16_t> (dict_input, value_hashes, out_arr); break;
+      case arrow::Type::UINT16:
+        GatherDictionary<uint16_t>(dict_input, value_hashes, out_arr); break;
+      case arrow::Type::INT32:
+        GatherDictionary<int32_t> (dict_input, value_hashes, out_arr); break;
+      case arrow::Type::UINT32:
+        GatherDictionary<uint32_t>(dict_input, value_hashes, out_arr); break;
+      case arrow::Type::INT64:
+        GatherDictionary<int64_t> (dict_input, value_hashes, out_arr); break;
+      case arrow::Type::UINT64:
+        GatherDictionary<uint64_t>(dict_input, value_hashes, out_arr); break;
+
+      default:
+        return Status::TypeError("Unsupported dictionary index type: ", *dict_input.type);
+    }
 
-    // >> Call hashing function
-    ARROW_LOG(INFO) << "Calling hash function";
-    vector<uint32_t> hash_results;
-    hash_results.resize(hash_input.length);
+    return Status::OK();
+  }
 
-    LightContext hash_ctx;
-    hash_ctx.hardware_flags = ctx->exec_context()->cpu_info()->hardware_flags();
-    hash_ctx.stack          = &stack_memallocator;
 
-    Hashing32::HashMultiColumn({ input_keycol }, &hash_ctx, hash_results.data());
+  // >> Run-end encoded input
+  /**
+   * Fills each run's rows with the run's hash, and sets their validity from the run's
+   * value. `run_hashes[0]` is the hash of the first run that overlaps the input's slice.
+   */
+  template <typename RunEndType>
+  static void
+  ExpandRuns( const ArraySpan &ree_input
+             ,int64_t          phys_offset
+             ,int64_t          phys_length
+             ,const uint32_t  *run_hashes
+             ,ArraySpan       *out_arr) {
+    const ArraySpan  &run_values   = arrow::ree_util::ValuesArray(ree_input);
+    const RunEndType *run_ends     = (
+      arrow::ree_util::RunEndsArray(ree_input).template GetValues<RunEndType>(1)
+    );
 
-    // >> Prepare results of hash function for kernel output argument
-    ARROW_LOG(INFO) << "Moving hash results to an Array";
-    UInt32Builder builder;
-    builder.Reserve(hash_results.size());
-    builder.AppendValues(hash_results);
+    uint32_t *hash_results = out_arr->GetValues<uint32_t>(1);
+    uint8_t  *out_validity = out_arr->buffers[0].data;
+    int64_t   null_count   = 0;
+    int64_t   row_start    = 0;
 
-    ARROW_ASSIGN_OR_RAISE(auto result_array, builder.Finish());
-    out->value = result_array->data();
+    for (int64_t run_ndx = 0; run_ndx < phys_length; ++run_ndx) {
+      // run ends are logical positions in the unsliced array
+      int64_t row_end = std::min<int64_t>(
+         run_ends[phys_offset + run_ndx] - ree_input.offset
+        ,ree_input.length
+      );
+
+      bool is_valid = run_values.IsValid(phys_offset + run_ndx);
+      std::fill(hash_results + row_start, hash_results + row_end, run_hashes[run_ndx]);
+      arrow::bit_util::SetBitsTo(
+         out_validity
+        ,out_arr->offset + row_start
+        ,row_end - row_start
+        ,is_valid
+      );
+
+      null_count += is_valid ? 0 : row_end - row_start;
+      row_start   = row_end;
+    }
+
+    out_arr->null_count = null_count;
+  }
+
+  /**
+   * A kernel for run-end encoded input. Only the runs that overlap the input's slice are
+   * hashed (once per run), then each run's hash is repeated across its rows.
+   *
+   * Run-end encoded arrays have no validity buffer of their own (nulls are null values),
+   * so this kernel is registered with `COMPUTED_PREALLOCATE` and writes the output validity
+   * itself.
+   */
+  static Status
+  ExecRunEndEncoded(KernelContext *ctx, const ExecSpan &input_arg, ExecResult *out) {
+    RECIPE_TRACE_KERNEL("named_scalar_fn:run_end_encoded", input_arg.length);
+    if (input_arg.num_values() != 1 or not input_arg[0].is_array()) {
+      return Status::Invalid("Unsupported argument types or shape");
+    }
+
+    const ArraySpan &ree_input   = input_arg[0].array;
+    int64_t          phys_offset = arrow::ree_util::FindPhysicalIndex(
+       ree_input
+      ,0
+      ,ree_input.offset
+    );
+    int64_t          phys_length = arrow::ree_util::FindPhysicalLength(ree_input);
+
+    // >> Hash each run's value once
+    ArraySpan run_values = arrow::ree_util::ValuesArray(ree_input);
+    run_values.SetSlice(run_values.offset + phys_offset, phys_length);
+
+    ARROW_ASSIGN_OR_RAISE(auto run_hashbuf, ctx->Allocate(phys_length * sizeof(uint32_t)));
+    RECIPE_TRACE_ALLOCATED(run_hashbuf->size());
+    auto run_hashes = reinterpret_cast<uint32_t*>(run_hashbuf->mutable_data());
+    ARROW_RETURN_NOT_OK(HashValues(ctx, run_values, run_hashes));
+
+    // >> Expand run hashes to rows
+    ArraySpan  *out_arr  = out->array_span();
+    const auto &ree_type = static_cast<const arrow::RunEndEncodedType&>(*ree_input.type);
+
+    switch (ree_type.run_end_type()->id()) {
+      case arrow::Type::INT16:
+        ExpandRuns<int16_t>(ree_input, phys_offset, phys_length, run_hashes, out_arr); break;
+      case arrow::Type::INT32:
+        ExpandRuns<int32_t>(ree_input, phys_offset, phys_length, run_hashes, out_arr); break;
+      case arrow::Type::INT64:
+        ExpandRuns<int64_t>(ree_input, phys_offset, phys_length, run_hashes, out_arr); break;
+
+      default:
+        return Status::TypeError("Unsupported run end type: ", *ree_input.type);
+    }
 
-    ARROW_LOG(INFO) << "Kernel execution complete";
     return Status::OK();
   }
 
@@ -130,15 +355,69 @@ RegisterScalarFnKernels() {
   );
 
   // Associate a kernel implementation with the function using
-  // `ScalarFunction::AddKernel()`
+  // `ScalarFunction::AddKernel()`. We add one kernel for each type that `Hashing32` can
+  // hash: fixed-width numerics and base binary types (binary, string and their large
+  // variants) have concrete types; fixed_size_binary is parameterized by its byte width,
+  // so it is matched by type id.
+  for (const auto &int_type : arrow::IntTypes()) {
+    DCHECK_OK(
+      fn_named_scalar->AddKernel(
+         { InputType(int_type) }
+        ,OutputType(arrow::uint32())
+        ,NamedScalarFn::Exec
+      )
+    );
+  }
+
+  for (const auto &float_type : arrow::FloatingPointTypes()) {
+    DCHECK_OK(
+      fn_named_scalar->AddKernel(
+         { InputType(float_type) }
+        ,OutputType(arrow::uint32())
+        ,NamedScalarFn::Exec
+      )
+    );
+  }
+
+  for (const auto &binary_type : arrow::BaseBinaryTypes()) {
+    DCHECK_OK(
+      fn_named_scalar->AddKernel(
+         { InputType(binary_type) }
+        ,OutputType(arrow::uint32())
+        ,NamedScalarFn::Exec
+      )
+    );
+  }
+
   DCHECK_OK(
     fn_named_scalar->AddKernel(
-       { InputType(arrow::int32()) }
+       { InputType(arrow::Type::FIXED_SIZE_BINARY) }
       ,OutputType(arrow::uint32())
       ,NamedScalarFn::Exec
     )
   );
 
+  // Encoded inputs get kernels that hash each distinct value (or run) once. These kernels
+  // compute output validity themselves, so they are constructed explicitly rather than
+  // through the `AddKernel` shorthand above.
+  ScalarKernel dict_kernel {
+     { InputType(arrow::Type::DICTIONARY) }
+    ,OutputType(arrow::uint32())
+    ,NamedScalarFn::ExecDictionary
+  };
+
+  dict_kernel.null_handling = NullHandling::COMPUTED_PREALLOCATE;
+  DCHECK_OK(fn_named_scalar->AddKernel(std::move(dict_kernel)));
+
+  ScalarKernel ree_kernel {
+     { InputType(arrow::Type::RUN_END_ENCODED) }
+    ,OutputType(arrow::uint32())
+    ,NamedScalarFn::ExecRunEndEncoded
+  };
+
+  ree_kernel.null_handling = NullHandling::COMPUTED_PREALLOCATE;
+  DCHECK_OK(fn_named_scalar->AddKernel(std::move(ree_kernel)));
+
   return fn_named_scalar;
 }
 
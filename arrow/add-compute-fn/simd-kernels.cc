@@ -0,0 +1,338 @@
+// ------------------------------
+// Dependencies
+
+#include "simd-kernels.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if RECIPE_X86_SIMD
+  #include <immintrin.h>
+#endif
+
+
+// ------------------------------
+// Scalar kernels
+
+// >> loops used on every platform, and for the tail of each SIMD loop
+
+/**
+ * Negating a signed integer wraps on overflow (the minimum value maps to itself), so the
+ * only negative results are overflows.
+ */
+template <typename CType>
+bool
+AbsSignedScalar(const CType *in, CType *out, int64_t n) {
+  using UType = std::make_unsigned_t<CType>;
+
+  CType overflow_bits = 0;
+  for (int64_t ndx = 0; ndx < n; ++ndx) {
+    CType val = in[ndx];
+    CType res = (val < 0) ? static_cast<CType>(UType(0) - static_cast<UType>(val)) : val;
+
+    overflow_bits |= res;
+    out[ndx]       = res;
+  }
+
+  return overflow_bits < 0;
+}
+
+template <typename CType>
+bool
+AbsFloatScalar(const CType *in, CType *out, int64_t n) {
+  for (int64_t ndx = 0; ndx < n; ++ndx) {
+    out[ndx] = std::fabs(in[ndx]);
+  }
+
+  return false;
+}
+
+template <typename CType>
+bool
+AbsUnsignedScalar(const CType *in, CType *out, int64_t n) {
+  if (in != out) { std::memcpy(out, in, n * sizeof(CType)); }
+  return false;
+}
+
+
+#if RECIPE_X86_SIMD
+
+// ------------------------------
+// SSE4.2 kernels (128-bit)
+
+template <typename CType>
+__attribute__((target("sse4.2")))
+inline __m128i
+BroadcastSse42(CType val) {
+  if      constexpr (sizeof(CType) == 1) { return _mm_set1_epi8 (static_cast<char>   (val)); }
+  else if constexpr (sizeof(CType) == 2) { return _mm_set1_epi16(static_cast<short>  (val)); }
+  else if constexpr (sizeof(CType) == 4) { return _mm_set1_epi32(static_cast<int>    (val)); }
+  else                                   { return _mm_set1_epi64x(static_cast<int64_t>(val)); }
+}
+
+template <typename CType>
+__attribute__((target("sse4.2")))
+inline __m128i
+AbsSse42(__m128i vals) {
+  if      constexpr (sizeof(CType) == 1) { return _mm_abs_epi8 (vals); }
+  else if constexpr (sizeof(CType) == 2) { return _mm_abs_epi16(vals); }
+  else if constexpr (sizeof(CType) == 4) { return _mm_abs_epi32(vals); }
+  else {
+    // there is no 64-bit abs before AVX-512: negate via (x ^ sign) - sign
+    __m128i sign = _mm_cmpgt_epi64(_mm_setzero_si128(), vals);
+    return _mm_sub_epi64(_mm_xor_si128(vals, sign), sign);
+  }
+}
+
+template <typename CType>
+__attribute__((target("sse4.2")))
+bool
+AbsSignedSse42(const CType *in, CType *out, int64_t n) {
+  constexpr int64_t lane_count = sizeof(__m128i) / sizeof(CType);
+
+  const __m128i sign_mask     = BroadcastSse42<CType>(std::numeric_limits<CType>::min());
+  __m128i       overflow_bits = _mm_setzero_si128();
+
+  int64_t ndx = 0;
+  for (; ndx + lane_count <= n; ndx += lane_count) {
+    __m128i vals = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + ndx));
+    __m128i res  = AbsSse42<CType>(vals);
+
+    overflow_bits = _mm_or_si128(overflow_bits, res);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + ndx), res);
+  }
+
+  bool overflowed = not _mm_testz_si128(overflow_bits, sign_mask);
+  return AbsSignedScalar(in + ndx, out + ndx, n - ndx) or overflowed;
+}
+
+/** Floats are made non-negative by clearing the sign bit of their IEEE-754 encoding. */
+template <typename CType>
+__attribute__((target("sse4.2")))
+bool
+AbsFloatSse42(const CType *in, CType *out, int64_t n) {
+  using BitsType = std::conditional_t<sizeof(CType) == 4, int32_t, int64_t>;
+  constexpr int64_t lane_count = sizeof(__m128i) / sizeof(CType);
+
+  const __m128i value_mask = BroadcastSse42<BitsType>(std::numeric_limits<BitsType>::max());
+
+  int64_t ndx = 0;
+  for (; ndx + lane_count <= n; ndx += lane_count) {
+    __m128i vals = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + ndx));
+    _mm_storeu_si128(
+       reinterpret_cast<__m128i*>(out + ndx)
+      ,_mm_and_si128(vals, value_mask)
+    );
+  }
+
+  return AbsFloatScalar(in + ndx, out + ndx, n - ndx);
+}
+
+
+// ------------------------------
+// AVX2 kernels (256-bit)
+
+template <typename CType>
+__attribute__((target("avx2")))
+inline __m256i
+BroadcastAvx2(CType val) {
+  if      constexpr (sizeof(CType) == 1) { return _mm256_set1_epi8 (static_cast<char>   (val)); }
+  else if constexpr (sizeof(CType) == 2) { return _mm256_set1_epi16(static_cast<short>  (val)); }
+  else if constexpr (sizeof(CType) == 4) { return _mm256_set1_epi32(static_cast<int>    (val)); }
+  else                                   { return _mm256_set1_epi64x(static_cast<int64_t>(val)); }
+}
+
+template <typename CType>
+__attribute__((target("avx2")))
+inline __m256i
+AbsAvx2(__m256i vals) {
+  if      constexpr (sizeof(CType) == 1) { return _mm256_abs_epi8 (vals); }
+  else if constexpr (sizeof(CType) == 2) { return _mm256_abs_epi16(vals); }
+  else if constexpr (sizeof(CType) == 4) { return _mm256_abs_epi32(vals); }
+  else {
+    __m256i sign = _mm256_cmpgt_epi64(_mm256_setzero_si256(), vals);
+    return _mm256_sub_epi64(_mm256_xor_si256(vals, sign), sign);
+  }
+}
+
+template <typename CType>
+__attribute__((target("avx2")))
+bool
+AbsSignedAvx2(const CType *in, CType *out, int64_t n) {
+  constexpr int64_t lane_count = sizeof(__m256i) / sizeof(CType);
+
+  const __m256i sign_mask     = BroadcastAvx2<CType>(std::numeric_limits<CType>::min());
+  __m256i       overflow_bits = _mm256_setzero_si256();
+
+  int64_t ndx = 0;
+  for (; ndx + lane_count <= n; ndx += lane_count) {
+    __m256i vals = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + ndx));
+    __m256i res  = AbsAvx2<CType>(vals);
+
+    overflow_bits = _mm256_or_si256(overflow_bits, res);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + ndx), res);
+  }
+
+  bool overflowed = not _mm256_testz_si256(overflow_bits, sign_mask);
+  return AbsSignedSse42(in + ndx, out + ndx, n - ndx) or overflowed;
+}
+
+template <typename CType>
+__attribute__((target("avx2")))
+bool
+AbsFloatAvx2(const CType *in, CType *out, int64_t n) {
+  using BitsType = std::conditional_t<sizeof(CType) == 4, int32_t, int64_t>;
+  constexpr int64_t lane_count = sizeof(__m256i) / sizeof(CType);
+
+  const __m256i value_mask = BroadcastAvx2<BitsType>(std::numeric_limits<BitsType>::max());
+
+  int64_t ndx = 0;
+  for (; ndx + lane_count <= n; ndx += lane_count) {
+    __m256i vals = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + ndx));
+    _mm256_storeu_si256(
+       reinterpret_cast<__m256i*>(out + ndx)
+      ,_mm256_and_si256(vals, value_mask)
+    );
+  }
+
+  return AbsFloatSse42(in + ndx, out + ndx, n - ndx);
+}
+
+
+// ------------------------------
+// AVX-512 kernels (512-bit)
+
+template <typename CType>
+__attribute__((target("avx512f,avx512bw")))
+inline __m512i
+BroadcastAvx512(CType val) {
+  if      constexpr (sizeof(CType) == 1) { return _mm512_set1_epi8 (static_cast<char>   (val)); }
+  else if constexpr (sizeof(CType) == 2) { return _mm512_set1_epi16(static_cast<short>  (val)); }
+  else if constexpr (sizeof(CType) == 4) { return _mm512_set1_epi32(static_cast<int>    (val)); }
+  else                                   { return _mm512_set1_epi64(static_cast<int64_t>(val)); }
+}
+
+template <typename CType>
+__attribute__((target("avx512f,avx512bw")))
+inline __m512i
+AbsAvx512(__m512i vals) {
+  if      constexpr (sizeof(CType) == 1) { return _mm512_abs_epi8 (vals); }
+  else if constexpr (sizeof(CType) == 2) { return _mm512_abs_epi16(vals); }
+  else if constexpr (sizeof(CType) == 4) { return _mm512_abs_epi32(vals); }
+  else                                   { return _mm512_abs_epi64(vals); }
+}
+
+template <typename CType>
+__attribute__((target("avx512f,avx512bw")))
+bool
+AbsSignedAvx512(const CType *in, CType *out, int64_t n) {
+  constexpr int64_t lane_count = sizeof(__m512i) / sizeof(CType);
+
+  const __m512i sign_mask     = BroadcastAvx512<CType>(std::numeric_limits<CType>::min());
+  __m512i       overflow_bits = _mm512_setzero_si512();
+
+  int64_t ndx = 0;
+  for (; ndx + lane_count <= n; ndx += lane_count) {
+    __m512i vals = _mm512_loadu_si512(in + ndx);
+    __m512i res  = AbsAvx512<CType>(vals);
+
+    overflow_bits = _mm512_or_si512(overflow_bits, res);
+    _mm512_storeu_si512(out + ndx, res);
+  }
+
+  bool overflowed = _mm512_test_epi64_mask(overflow_bits, sign_mask) != 0;
+  return AbsSignedAvx2(in + ndx, out + ndx, n - ndx) or overflowed;
+}
+
+template <typename CType>
+__attribute__((target("avx512f,avx512bw")))
+bool
+AbsFloatAvx512(const CType *in, CType *out, int64_t n) {
+  using BitsType = std::conditional_t<sizeof(CType) == 4, int32_t, int64_t>;
+  constexpr int64_t lane_count = sizeof(__m512i) / sizeof(CType);
+
+  const __m512i value_mask = BroadcastAvx512<BitsType>(std::numeric_limits<BitsType>::max());
+
+  int64_t ndx = 0;
+  for (; ndx + lane_count <= n; ndx += lane_count) {
+    __m512i vals = _mm512_loadu_si512(in + ndx);
+    _mm512_storeu_si512(out + ndx, _mm512_and_si512(vals, value_mask));
+  }
+
+  return AbsFloatAvx2(in + ndx, out + ndx, n - ndx);
+}
+
+#endif  // RECIPE_X86_SIMD
+
+
+// ------------------------------
+// Dispatch
+
+SimdLevel
+SimdLevelFromFlags(int64_t hardware_flags) {
+#if RECIPE_X86_SIMD
+  if ((hardware_flags & CpuInfo::AVX512) == CpuInfo::AVX512) { return SimdLevel::AVX512; }
+  if  (hardware_flags & CpuInfo::AVX2)                       { return SimdLevel::AVX2;   }
+  if  (hardware_flags & CpuInfo::SSE4_2)                     { return SimdLevel::SSE4_2; }
+#endif
+
+  return SimdLevel::Scalar;
+}
+
+const char*
+SimdLevelName(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::AVX512: return "avx512";
+    case SimdLevel::AVX2:   return "avx2";
+    case SimdLevel::SSE4_2: return "sse4.2";
+    default:                return "scalar";
+  }
+}
+
+template <typename CType>
+AbsLoop<CType>
+SelectAbsLoop(SimdLevel level) {
+  if constexpr (std::is_unsigned<CType>::value) {
+    return AbsUnsignedScalar<CType>;
+  }
+
+  else if constexpr (std::is_floating_point<CType>::value) {
+#if RECIPE_X86_SIMD
+    switch (level) {
+      case SimdLevel::AVX512: return AbsFloatAvx512<CType>;
+      case SimdLevel::AVX2:   return AbsFloatAvx2<CType>;
+      case SimdLevel::SSE4_2: return AbsFloatSse42<CType>;
+      default:                break;
+    }
+#endif
+
+    return AbsFloatScalar<CType>;
+  }
+
+  else {
+#if RECIPE_X86_SIMD
+    switch (level) {
+      case SimdLevel::AVX512: return AbsSignedAvx512<CType>;
+      case SimdLevel::AVX2:   return AbsSignedAvx2<CType>;
+      case SimdLevel::SSE4_2: return AbsSignedSse42<CType>;
+      default:                break;
+    }
+#endif
+
+    return AbsSignedScalar<CType>;
+  }
+}
+
+
+// >> explicit instantiations for every numeric C type
+template AbsLoop<int8_t>   SelectAbsLoop<int8_t>  (SimdLevel);
+template AbsLoop<int16_t>  SelectAbsLoop<int16_t> (SimdLevel);
+template AbsLoop<int32_t>  SelectAbsLoop<int32_t> (SimdLevel);
+template AbsLoop<int64_t>  SelectAbsLoop<int64_t> (SimdLevel);
+template AbsLoop<uint8_t>  SelectAbsLoop<uint8_t> (SimdLevel);
+template AbsLoop<uint16_t> SelectAbsLoop<uint16_t>(SimdLevel);
+template AbsLoop<uint32_t> SelectAbsLoop<uint32_t>(SimdLevel);
+template AbsLoop<uint64_t> SelectAbsLoop<uint64_t>(SimdLevel);
+template AbsLoop<float>    SelectAbsLoop<float>   (SimdLevel);
+template AbsLoop<double>   SelectAbsLoop<double>  (SimdLevel);
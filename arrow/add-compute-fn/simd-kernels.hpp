@@ -0,0 +1,64 @@
+#pragma once
+
+
+// ------------------------------
+// Dependencies
+
+#include "support.hpp"
+
+#include <arrow/util/cpu_info.h>
+
+
+// ------------------------------
+// Macros and aliases
+
+// x86 kernels are compiled with per-function target attributes, so this translation unit
+// doesn't need `-mavx2` (or similar) and the binary still runs on older CPUs.
+#if defined(__GNUC__) and (defined(__x86_64__) or defined(__i386__))
+  #define RECIPE_X86_SIMD 1
+#else
+  #define RECIPE_X86_SIMD 0
+#endif
+
+using arrow::internal::CpuInfo;
+
+
+// ------------------------------
+// Types
+
+/** Instruction sets that we have explicit kernels for, from narrowest to widest. */
+enum class SimdLevel { Scalar, SSE4_2, AVX2, AVX512 };
+
+/**
+ * A loop that writes the absolute value of `n` elements of `in` to `out`. `in` and `out`
+ * may be the same buffer.
+ *
+ * The return value is true if any element overflowed, which only happens when negating
+ * the minimum value of a signed integer. Loops detect this without branching: the
+ * absolute value of every other element is non-negative, so ORing all results together
+ * and testing the sign bit once at the end finds any overflow.
+ */
+template <typename CType>
+using AbsLoop = bool (*)(const CType *in, CType *out, int64_t n);
+
+
+// ------------------------------
+// Functions
+
+// >> dispatch
+/** Returns the widest `SimdLevel` supported by `hardware_flags` (from `CpuInfo`). */
+SimdLevel
+SimdLevelFromFlags(int64_t hardware_flags);
+
+/** Returns the name of `level`, for logging which kernels were selected. */
+const char*
+SimdLevelName(SimdLevel level);
+
+/**
+ * Returns the absolute value loop for `CType` at `level`. Every numeric C type has a loop
+ * at every level; levels without an explicit kernel for a type fall back to the scalar
+ * loop (e.g. unsigned integers, which only need a copy).
+ */
+template <typename CType>
+AbsLoop<CType>
+SelectAbsLoop(SimdLevel level);
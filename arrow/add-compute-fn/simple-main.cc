@@ -1,4 +1,8 @@
 #include "recipe.hpp"
+#include "hash-columns.hpp"
+#include "approx-count-distinct.hpp"
+#include "bloom.hpp"
+#include "executor.hpp"
 
 Result<shared_ptr<Array>>
 BuildIntArray() {
@@ -39,5 +43,71 @@ int main(int argc, char **argv) {
   auto result_data = fn_result->make_array();
   std::cout << "Success:"                      << std::endl;
   std::cout << "\t" << result_data->ToString() << std::endl;
+
+  // >> Invoke a variadic compute function, combining 2 key columns into 1 hash per row
+  RegisterHashColumnsFn(fn_registry);
+
+  auto multicol_result = HashColumns(
+     { col_as_datum, col_as_datum }
+    ,HashColumnsOptions(64)
+  );
+  if (not multicol_result.ok()) {
+    std::cerr << multicol_result.status().message() << std::endl;
+    return 3;
+  }
+
+  std::cout << "Multi-column hashes:"                           << std::endl;
+  std::cout << "\t" << multicol_result->make_array()->ToString() << std::endl;
+
+  // >> Invoke an aggregate compute function, estimating distinct values from their hashes
+  RegisterApproxCountDistinctFn(fn_registry);
+
+  auto distinct_result = ApproxCountDistinct(col_as_datum);
+  if (not distinct_result.ok()) {
+    std::cerr << distinct_result.status().message() << std::endl;
+    return 4;
+  }
+
+  std::cout << "Approximate distinct count:"                    << std::endl;
+  std::cout << "\t" << distinct_result->scalar()->ToString()    << std::endl;
+
+  // >> Build a bloom filter from some keys, then probe it with every value
+  RegisterBloomFilterFns(fn_registry);
+
+  auto key_vals = Datum(col_vals->Slice(0, 5));
+  auto filter   = BloomBuild(key_vals);
+  if (not filter.ok()) {
+    std::cerr << filter.status().message() << std::endl;
+    return 5;
+  }
+
+  auto probe_result = BloomProbe(col_as_datum, *filter);
+  if (not probe_result.ok()) {
+    std::cerr << probe_result.status().message() << std::endl;
+    return 6;
+  }
+
+  std::cout << "Bloom filter probe (keys: " << key_vals.make_array()->ToString() << "):"
+            << std::endl;
+  std::cout << "\t" << probe_result->make_array()->ToString() << std::endl;
+
+  // >> Resolve "named_scalar_fn" once, then call it on a stream of small batches
+  auto resolved_fn = ResolvedKernel::Make("named_scalar_fn", { col_vals->type() });
+  if (not resolved_fn.ok()) {
+    std::cerr << resolved_fn.status().message() << std::endl;
+    return 7;
+  }
+
+  std::cout << "Resolved kernel, called per batch:" << std::endl;
+  for (int64_t batch_start = 0; batch_start < col_vals->length(); batch_start += 4) {
+    auto batch_result = (*resolved_fn)->Call({ Datum(col_vals->Slice(batch_start, 4)) });
+    if (not batch_result.ok()) {
+      std::cerr << batch_result.status().message() << std::endl;
+      return 8;
+    }
+
+    std::cout << "\t" << batch_result->make_array()->ToString() << std::endl;
+  }
+
   return 0;
 }
@@ -8,6 +8,15 @@
 // ------------------------------
 // Macros and aliases
 
+/**
+ * A `TempVectorStack` and the number of bytes it was initialized with. `TempVectorStack`
+ * does not expose its size, so we track it alongside the stack.
+ */
+struct SizedTempVectorStack {
+  int64_t         capacity = 0;
+  TempVectorStack stack;
+};
+
 
 // ------------------------------
 // Functions
@@ -33,3 +42,32 @@ ConstructStrArray(vector<string> src_vector) {
 
     return str_array;
 }
+
+
+// >> scratch memory for hashing
+
+/**
+ * Returns a `TempVectorStack` owned by the calling thread that has at least `min_size`
+ * bytes. The stack is initialized on first use and re-initialized only when a caller
+ * needs more than it has, so repeated kernel calls on the same thread do not allocate.
+ *
+ * The stack's memory comes from the default memory pool rather than a caller's pool,
+ * because it lives until the thread exits and must not outlive the pool it came from.
+ * Callers must release everything they allocate from the stack before returning.
+ */
+Result<TempVectorStack*>
+ThreadLocalHashStack(int64_t min_size) {
+    thread_local SizedTempVectorStack tls_stack;
+
+    if (tls_stack.capacity < min_size) {
+        // Grow geometrically so a slowly increasing requirement doesn't re-initialize often
+        int64_t new_capacity = std::max(min_size, 2 * tls_stack.capacity);
+        ARROW_RETURN_NOT_OK(
+            tls_stack.stack.Init(arrow::default_memory_pool(), new_capacity)
+        );
+
+        tls_stack.capacity = new_capacity;
+    }
+
+    return &tls_stack.stack;
+}
@@ -8,11 +8,18 @@
 #include <stdint.h>
 #include <string>
 #include <iostream>
+#include <algorithm>
+#include <memory>
 
 // arrow dependencies
 #include <arrow/api.h>
 #include <arrow/compute/api.h>
 #include <arrow/compute/exec/key_hash.h>
+#include <arrow/util/bit_util.h>
+#include <arrow/util/ree_util.h>
+
+// local dependencies
+#include "instrumentation.hpp"
 
 
 // ------------------------------
@@ -49,6 +56,7 @@ using arrow::StringBuilder;
 //    |> kernel parameters
 using arrow::compute::KernelContext;
 using arrow::compute::ExecSpan;
+using arrow::compute::ExecValue;
 using arrow::compute::ExecResult;
 
 //    |> common types for compute functions
@@ -57,9 +65,25 @@ using arrow::compute::FunctionDoc;
 using arrow::compute::InputType;
 using arrow::compute::OutputType;
 using arrow::compute::Arity;
+using arrow::TypeHolder;
+
+//    |> options and kernel state
+using arrow::compute::FunctionOptions;
+using arrow::compute::FunctionOptionsType;
+using arrow::compute::KernelState;
+using arrow::compute::KernelInitArgs;
+
+//    |> kernel construction (when `AddKernel` shorthand isn't enough)
+using arrow::compute::ScalarKernel;
+using arrow::compute::ArrayKernelExec;
+using arrow::compute::KernelSignature;
+using arrow::compute::NullHandling;
+using arrow::compute::MemAllocation;
 
 //    |> the "kind" of function we want
 using arrow::compute::ScalarFunction;
+using arrow::compute::ScalarAggregateFunction;
+using arrow::compute::ScalarAggregateKernel;
 
 //    |> other context types
 using arrow::compute::ExecContext;
@@ -68,9 +92,12 @@ using arrow::compute::LightContext;
 //    |> for hashing
 using arrow::util::MiniBatch;
 using arrow::util::TempVectorStack;
+using arrow::util::TempVectorHolder;
 
+using arrow::compute::KeyColumnMetadata;
 using arrow::compute::KeyColumnArray;
 using arrow::compute::Hashing32;
+using arrow::compute::Hashing64;
 
 
 // ----------
@@ -78,14 +105,107 @@ using arrow::compute::Hashing32;
 
 // >> functions used for setup
 using arrow::compute::default_exec_context;
+using arrow::compute::CallFunction;
 
 // >> functions used in kernel for `NamedScalarFn`
 using arrow::compute::ColumnArrayFromArrayData;
 
 
+// ------------------------------
+// Constants
+
+// >> scratch memory for hashing
+/**
+ * The hash functions walk their input in minibatches, so the scratch memory they take from
+ * a `TempVectorStack` does not depend on input length or type width. Each vector taken
+ * from the stack is padded by 64 bytes (for SIMD tails) plus 16 bytes of guard words.
+ *
+ * `Hashing32::HashMultiColumn` takes 3 vectors: uint32 hashes, uint16 null indices and
+ * uint32 null hashes. `Hashing64::HashMultiColumn` takes 2: uint16 null indices and uint64
+ * null hashes.
+ */
+constexpr int64_t hash32_stacksize = (
+    (MiniBatch::kMiniBatchLength * sizeof(uint32_t) + 80)
+  + (MiniBatch::kMiniBatchLength * sizeof(uint16_t) + 80)
+  + (MiniBatch::kMiniBatchLength * sizeof(uint32_t) + 80)
+);
+
+constexpr int64_t hash64_stacksize = (
+    (MiniBatch::kMiniBatchLength * sizeof(uint16_t) + 80)
+  + (MiniBatch::kMiniBatchLength * sizeof(uint64_t) + 80)
+);
+
+
+// ------------------------------
+// Classes
+
+// >> boilerplate for custom function options
+/**
+ * A `FunctionOptionsType` for options classes defined in these recipes. The built-in
+ * options classes generate this with internal helpers, which aren't installed with arrow.
+ *
+ * `OptionsType` must provide:
+ *  - `kTypeName`, a unique name for the options type
+ *  - `Describe()`, a string representation of the options
+ *  - `IsEqual()`, a comparison with another instance of `OptionsType`
+ */
+template <typename OptionsType>
+class RecipeOptionsType : public FunctionOptionsType {
+  public:
+    const char*
+    type_name() const override { return OptionsType::kTypeName; }
+
+    string
+    Stringify(const FunctionOptions &options) const override {
+      return static_cast<const OptionsType&>(options).Describe();
+    }
+
+    bool
+    Compare(const FunctionOptions &lhs, const FunctionOptions &rhs) const override {
+      return static_cast<const OptionsType&>(lhs).IsEqual(
+        static_cast<const OptionsType&>(rhs)
+      );
+    }
+
+    std::unique_ptr<FunctionOptions>
+    Copy(const FunctionOptions &options) const override {
+      return std::make_unique<OptionsType>(static_cast<const OptionsType&>(options));
+    }
+};
+
+/**
+ * A `KernelState` that holds a copy of a kernel's options. `Init` is passed as the
+ * `KernelInit` of a kernel, and the kernel reads its options back with `Get`.
+ */
+template <typename OptionsType>
+struct OptionsState : public KernelState {
+  explicit OptionsState(OptionsType opts) : options(std::move(opts)) {}
+
+  static Result<std::unique_ptr<KernelState>>
+  Init(KernelContext*, const KernelInitArgs &args) {
+    if (args.options == nullptr) {
+      return Status::Invalid("Attempted to call a kernel without options");
+    }
+
+    return std::make_unique<OptionsState>(static_cast<const OptionsType&>(*args.options));
+  }
+
+  static const OptionsType&
+  Get(KernelContext *ctx) {
+    return static_cast<const OptionsState*>(ctx->state())->options;
+  }
+
+  OptionsType options;
+};
+
+
 // ------------------------------
 // Functions
 
 // >> construction
 Result<shared_ptr<StringArray>>
 ConstructStrArray(vector<string> src_vector);
+
+// >> scratch memory for hashing
+Result<TempVectorStack*>
+ThreadLocalHashStack(int64_t min_size);
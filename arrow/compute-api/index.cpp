@@ -36,5 +36,133 @@ int main(int argc, char **argv) {
     // View the result
     std::cout << "Index of value [" << search_val << "]: " << *index_result << std::endl;
 
+    // For repeated lookups, build an index once; each lookup is then a hash probe
+    auto value_index = ValueIndex::Build(str_chunkedarr);
+    if (not value_index.ok()) {
+        std::cerr << "Could not build value index:"       << std::endl
+                  << "\t" << value_index.status().message() << std::endl
+        ;
+
+        return 1;
+    }
+
+    for (string lookup_val : { "val4", "val0", "missing" }) {
+        auto lookup_result = IndexOf(str_chunkedarr, lookup_val, value_index->get());
+        if (not lookup_result.ok()) {
+            std::cerr << "Could not look up value [" << lookup_val << "]" << std::endl;
+            return 1;
+        }
+
+        std::cout << "Index of value [" << lookup_val << "] (indexed): " << *lookup_result
+                  << std::endl
+        ;
+    }
+
+    // To look up many values once, search for all of them in a single scan
+    auto search_vals   = ConstructStrArray({ "val3", "missing", "val1", "val3" });
+    auto batch_results = IndexOf(str_chunkedarr, **search_vals);
+    if (not batch_results.ok()) {
+        std::cerr << "Could not search for values:"          << std::endl
+                  << "\t" << batch_results.status().message() << std::endl
+        ;
+
+        return 1;
+    }
+
+    std::cout << "Indices of values " << (*search_vals)->ToString()   << ":" << std::endl
+              << (*batch_results)->ToString()                         << std::endl
+    ;
+
+    // On a large column, a single value can be searched for on every core at once
+    auto parallel_result = IndexOfParallel(str_chunkedarr, "val4");
+    if (not parallel_result.ok()) {
+        std::cerr << "Could not search in parallel:"           << std::endl
+                  << "\t" << parallel_result.status().message() << std::endl
+        ;
+
+        return 1;
+    }
+
+    std::cout << "Index of value [val4] (parallel): " << *parallel_result << std::endl;
+
+    // Numeric (and other primitive) columns are searched with a loop specialized to the type
+    arrow::Int64Builder int_builder;
+    auto append_status = int_builder.AppendValues({ 10, 20, 30, 40, 50 });
+    if (not append_status.ok()) {
+        std::cerr << "Could not append int64 values:" << std::endl
+                  << "\t" << append_status.message()  << std::endl
+        ;
+
+        return 1;
+    }
+
+    auto int_arr = int_builder.Finish();
+    if (not int_arr.ok()) {
+        std::cerr << "Could not build int64 column:"   << std::endl
+                  << "\t" << int_arr.status().message() << std::endl
+        ;
+
+        return 1;
+    }
+
+    auto int_chunkedarr = std::make_shared<ChunkedArray>(*int_arr);
+    auto typed_result   = IndexOf(int_chunkedarr, MakeScalar(int64_t { 40 }));
+    if (not typed_result.ok()) {
+        std::cerr << "Could not search int64 column:"       << std::endl
+                  << "\t" << typed_result.status().message() << std::endl
+        ;
+
+        return 1;
+    }
+
+    std::cout << "Index of value [40] (int64): " << *typed_result << std::endl;
+
+    // The int64 column is sorted, so a sorted index searches it in place (binary search)
+    auto sorted_index = SortedIndex::Build(int_chunkedarr);
+    if (not sorted_index.ok()) {
+        std::cerr << "Could not build sorted index:"         << std::endl
+                  << "\t" << sorted_index.status().message() << std::endl
+        ;
+
+        return 1;
+    }
+
+    auto sorted_result = IndexOf(int_chunkedarr, MakeScalar(int64_t { 20 }), sorted_index->get());
+    auto range_result  = (*sorted_index)->Range(
+         MakeScalar(int64_t { 15 })
+        ,MakeScalar(int64_t { 45 })
+    );
+
+    if (not sorted_result.ok() or not range_result.ok()) {
+        std::cerr << "Could not search sorted index" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Index of value [20] (sorted): " << *sorted_result              << std::endl
+              << "Indices of values in [15, 45) (sorted):"                        << std::endl
+              << (*range_result)->ToString()                                      << std::endl
+    ;
+
+    // A zone map skips every chunk whose [min, max] doesn't include the value (here, all)
+    auto zone_map = ZoneMap::Build(int_chunkedarr);
+    if (not zone_map.ok()) {
+        std::cerr << "Could not build zone map:"         << std::endl
+                  << "\t" << zone_map.status().message() << std::endl
+        ;
+
+        return 1;
+    }
+
+    auto zoned_result = IndexOf(int_chunkedarr, MakeScalar(int64_t { 60 }), zone_map->get());
+    if (not zoned_result.ok()) {
+        std::cerr << "Could not search with zone map:"       << std::endl
+                  << "\t" << zoned_result.status().message() << std::endl
+        ;
+
+        return 1;
+    }
+
+    std::cout << "Index of value [60] (zone map): " << *zoned_result << std::endl;
+
     return 0;
 }
@@ -0,0 +1,96 @@
+#pragma once
+
+// ------------------------------
+// Dependencies
+
+#include "recipe.hpp"
+
+#include <cmath>
+#include <type_traits>
+#include <arrow/visit_type_inline.h>
+
+
+// ------------------------------
+// Functions
+
+// >> Ordering values of any type (used by `SortedIndex` and `ZoneMap`)
+
+/** The types whose values can be ordered: numbers, temporals and binary values. */
+template <typename ArrowType>
+constexpr bool
+IsOrderedType() {
+    if constexpr (arrow::is_base_binary_type<ArrowType>::value) {
+        return true;
+    }
+
+    // Half floats are stored as bits, which don't sort like the values they stand for
+    else if constexpr (std::is_same<ArrowType, arrow::HalfFloatType>::value) {
+        return false;
+    }
+
+    else if constexpr (    arrow::is_number_type<ArrowType>::value
+                       or  arrow::is_temporal_type<ArrowType>::value) {
+        return std::is_arithmetic<typename ArrowType::c_type>::value;
+    }
+
+    else {
+        return false;
+    }
+}
+
+/**
+ * The order `SortIndices` uses: NaN sorts after every other float. Comparing with only `<`
+ * would make NaN "equal" to everything, and binary search would go astray.
+ */
+template <typename ValueType>
+bool
+SortsBefore(const ValueType &left_val, const ValueType &right_val) {
+    if constexpr (std::is_floating_point<ValueType>::value) {
+        return left_val < right_val or (not std::isnan(left_val) and std::isnan(right_val));
+    }
+
+    else {
+        return left_val < right_val;
+    }
+}
+
+/** The value of `scalar_val` (of type `ArrowType`), as it's compared to a column's values. */
+template <typename ArrowType>
+auto
+ScalarKey(const Scalar &scalar_val) {
+    if constexpr (arrow::is_base_binary_type<ArrowType>::value) {
+        const auto &binary_scalar = static_cast<const arrow::BaseBinaryScalar&>(scalar_val);
+
+        return std::string_view {
+             reinterpret_cast<const char*>(binary_scalar.value->data())
+            ,static_cast<size_t>(binary_scalar.value->size())
+        };
+    }
+
+    else {
+        using ScalarType = typename arrow::TypeTraits<ArrowType>::ScalarType;
+        return static_cast<const ScalarType&>(scalar_val).value;
+    }
+}
+
+/** Calls `visit_fn(arrow_type)` with the concrete type, if it's an ordered type. */
+template <typename VisitFn>
+struct OrderedTypeVisitor {
+    VisitFn &visit_fn;
+
+    template <typename ArrowType>
+    Status
+    Visit(const ArrowType &arrow_type) {
+        if constexpr (IsOrderedType<ArrowType>()) { return visit_fn(arrow_type); }
+        else {
+            return Status::NotImplemented("Values of type ", arrow_type, " can't be ordered");
+        }
+    }
+};
+
+template <typename VisitFn>
+Status
+VisitOrderedType(const arrow::DataType &data_type, VisitFn &&visit_fn) {
+    OrderedTypeVisitor<VisitFn> type_visitor { visit_fn };
+    return arrow::VisitTypeInline(data_type, &type_visitor);
+}
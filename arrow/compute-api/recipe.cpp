@@ -37,6 +37,21 @@ IndexOf(shared_ptr<ChunkedArray> source_arr, string &search_str) {
 }
 
 
+/**
+ * Like `IndexOf` above, but answers from `value_index` (a hash probe) instead of scanning
+ * `source_arr`. If `source_arr` isn't the column the index was built from, the index is
+ * refreshed first, so lookups never see stale positions.
+ */
+Result<int64_t>
+IndexOf(shared_ptr<ChunkedArray> source_arr, string &search_str, ValueIndex *value_index) {
+    if (not value_index->IsCurrent(*source_arr)) {
+        ARROW_RETURN_NOT_OK(value_index->Refresh(source_arr));
+    }
+
+    return value_index->Lookup(search_str);
+}
+
+
 // ------------------------------
 // Convenience Functions
 
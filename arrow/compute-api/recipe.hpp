@@ -6,7 +6,9 @@
 // standard dependencies
 #include <stdint.h>
 #include <string>
+#include <string_view>
 #include <iostream>
+#include <unordered_map>
 
 // arrow dependencies
 #include <arrow/api.h>
@@ -36,8 +38,12 @@ using arrow::Int64Scalar;
 using arrow::Array;
 using arrow::ArrayVector;
 using arrow::StringArray;
+using arrow::Int64Array;
 using arrow::ChunkedArray;
 
+// >> execution
+using arrow::compute::ExecContext;
+
 // arrow functions
 using arrow::MakeScalar;
 
@@ -46,6 +52,161 @@ using arrow::compute::Index;
 using arrow::compute::IndexOptions;
 
 
+// ------------------------------
+// Classes
+
+/** Where a value is in a `ChunkedArray`: which chunk, and the offset within that chunk. */
+struct ChunkLocation {
+    int     chunk_ndx;
+    int64_t chunk_offset;
+};
+
+/**
+ * A hash index over a string (or binary) `ChunkedArray`, mapping each distinct value to
+ * its first position. Building it is one scan of the column; after that, each lookup is
+ * a hash probe instead of a scan.
+ *
+ * Keys are views of the column's data buffers (they aren't copied), so the index holds a
+ * reference to the column it indexes. Arrow arrays are immutable, so "the column changed"
+ * means the caller has a different `ChunkedArray`: `IsCurrent` detects that, and `Refresh`
+ * updates the index (indexing only the new chunks, if chunks were only appended).
+ */
+class ValueIndex {
+    public:
+        static Result<std::unique_ptr<ValueIndex>>
+        Build(shared_ptr<ChunkedArray> source_arr);
+
+        /** True if this index was built from exactly the chunks of `source_arr`. */
+        bool
+        IsCurrent(const ChunkedArray &source_arr) const;
+
+        /** Brings this index up to date with `source_arr` (a no-op if it's current). */
+        Status
+        Refresh(shared_ptr<ChunkedArray> source_arr);
+
+        /** Returns the index of the first occurrence of `search_val`, or -1. */
+        int64_t
+        Lookup(std::string_view search_val) const;
+
+        /** Returns the chunk location of the first occurrence of `search_val`, if any. */
+        bool
+        Locate(std::string_view search_val, ChunkLocation *location) const;
+
+        int64_t
+        size() const { return static_cast<int64_t>(first_locations.size()); }
+
+    private:
+        Status
+        IndexChunks(int first_chunk_ndx);
+
+        shared_ptr<ChunkedArray>                              indexed_arr;
+        vector<int64_t>                                       chunk_starts;
+        std::unordered_map<std::string_view, ChunkLocation>   first_locations;
+};
+
+/**
+ * Answers lookups and range queries on a primitive, string or binary `ChunkedArray` by
+ * binary search. If the column is sorted (non-null values ascending, nulls last), it's
+ * searched in place, across chunk boundaries. Otherwise, `Build` computes a (stable) sort
+ * permutation of the column once, and searches through it.
+ *
+ * Checking whether the column is sorted is one scan; a caller that knows the column is
+ * sorted (e.g. it was written that way) can pass `is_sorted` to skip it. That also holds
+ * for the columns the index is refreshed with.
+ */
+class SortedIndex {
+    public:
+        static Result<std::unique_ptr<SortedIndex>>
+        Build(shared_ptr<ChunkedArray> source_arr, bool is_sorted = false);
+
+        /** True if this index was built from exactly the chunks of `source_arr`. */
+        bool
+        IsCurrent(const ChunkedArray &source_arr) const;
+
+        /** Rebuilds this index for `source_arr` (a no-op if it's current). */
+        Status
+        Refresh(shared_ptr<ChunkedArray> source_arr);
+
+        /** True if the column was searched in place (no sort permutation was needed). */
+        bool
+        IsInPlace() const { return sort_indices == nullptr; }
+
+        /** Returns the index of the first occurrence of `search_val`, or -1. */
+        Result<int64_t>
+        Lookup(shared_ptr<Scalar> search_val) const;
+
+        /**
+         * Returns the indices of values in `[lower_val, upper_val)`, in order of value (and
+         * of position, for equal values).
+         */
+        Result<shared_ptr<Int64Array>>
+        Range(shared_ptr<Scalar> lower_val, shared_ptr<Scalar> upper_val) const;
+
+    private:
+        Status
+        IndexChunks();
+
+        int64_t
+        RowAt(int64_t sorted_ndx) const;
+
+        shared_ptr<ChunkedArray>                              indexed_arr;
+        vector<int64_t>                                       chunk_starts;
+        bool                                                  assume_sorted  { false };
+
+        // Sorted positions of the non-null values; null when `indexed_arr` is sorted
+        shared_ptr<arrow::UInt64Array>                        sort_indices;
+        int64_t                                               sorted_length  { 0 };
+};
+
+/**
+ * The statistics of one chunk. `min_val` and `max_val` are null if the chunk has no
+ * values to compare (every value is null, or NaN), or if its type can't be ordered.
+ */
+struct ChunkStatistics {
+    shared_ptr<Scalar> min_val;
+    shared_ptr<Scalar> max_val;
+    int64_t            null_count;
+};
+
+/**
+ * Per-chunk min, max and null count (a "zone map") of a primitive, string or binary
+ * `ChunkedArray`. A search can skip every chunk whose `[min, max]` doesn't include the
+ * value it's looking for, without reading the chunk.
+ *
+ * Building it is one scan of the column. Chunks are independent, so if chunks were only
+ * appended, `Refresh` computes statistics for just the new ones. A column whose type
+ * can't be ordered (e.g. boolean) only gets null counts, so no chunk is skipped.
+ */
+class ZoneMap {
+    public:
+        static Result<std::unique_ptr<ZoneMap>>
+        Build(shared_ptr<ChunkedArray> source_arr);
+
+        /** True if this zone map was built from exactly the chunks of `source_arr`. */
+        bool
+        IsCurrent(const ChunkedArray &source_arr) const;
+
+        /** Brings this zone map up to date with `source_arr` (a no-op if it's current). */
+        Status
+        Refresh(shared_ptr<ChunkedArray> source_arr);
+
+        /** False if `search_val` (of the column's type) can't be in chunk `chunk_ndx`. */
+        bool
+        MayContain(int chunk_ndx, const Scalar &search_val) const;
+
+        const ChunkStatistics&
+        chunk_stats(int chunk_ndx) const { return stats_by_chunk[chunk_ndx]; }
+
+    private:
+        Status
+        ComputeStatistics(int first_chunk_ndx);
+
+        shared_ptr<ChunkedArray>                              indexed_arr;
+        vector<ChunkStatistics>                               stats_by_chunk;
+        bool                                                  is_ordered { false };
+};
+
+
 // ------------------------------
 // Functions
 
@@ -53,8 +214,43 @@ using arrow::compute::IndexOptions;
 Result<int64_t>
 IndexOf(shared_ptr<ChunkedArray> source_arr, string &search_str);
 
+Result<int64_t>
+IndexOf(shared_ptr<ChunkedArray> source_arr, string &search_str, ValueIndex *value_index);
+
+Result<shared_ptr<Int64Array>>
+IndexOf(shared_ptr<ChunkedArray> source_arr, const Array &search_vals);
+
+Result<int64_t>
+IndexOf(shared_ptr<ChunkedArray> source_arr, shared_ptr<Scalar> search_val);
+
+Result<int64_t>
+IndexOf( shared_ptr<ChunkedArray>  source_arr
+        ,shared_ptr<Scalar>        search_val
+        ,SortedIndex              *sorted_index);
+
+Result<int64_t>
+IndexOf( shared_ptr<ChunkedArray>  source_arr
+        ,shared_ptr<Scalar>        search_val
+        ,ZoneMap                  *zone_map);
+
+Result<int64_t>
+IndexOfParallel( shared_ptr<ChunkedArray>  source_arr
+                ,const string             &search_str
+                ,ExecContext              *ctx            = nullptr
+                ,int64_t                   max_range_rows = 1 << 16);
+
 // convenience functions
 
 // >> construction
 Result<shared_ptr<StringArray>>
 ConstructStrArray(vector<string> src_vector);
+
+// >> comparison
+bool
+HasSameChunks(const ChunkedArray &left_arr, const ChunkedArray &right_arr);
+
+int
+CountSameLeadingChunks(const ChunkedArray &left_arr, const ChunkedArray &right_arr);
+
+Result<shared_ptr<Scalar>>
+CastToColumnType(shared_ptr<Scalar> search_val, const shared_ptr<arrow::DataType> &col_type);
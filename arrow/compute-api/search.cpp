@@ -0,0 +1,229 @@
+// ------------------------------
+// Dependencies
+
+// Local and third-party dependencies
+#include "recipe.hpp"
+
+#include <atomic>
+#include <arrow/util/parallel.h>
+#include <arrow/util/thread_pool.h>
+
+// ------------------------------
+// Macros and aliases
+
+using arrow::BinaryArray;
+using arrow::LargeBinaryArray;
+using arrow::Int64Builder;
+
+
+// ------------------------------
+// Functions
+
+// >> Visiting string values
+
+bool
+IsBinaryLike(const arrow::DataType &data_type) {
+    auto type_id = data_type.id();
+    return (
+           type_id == arrow::Type::STRING       or type_id == arrow::Type::BINARY
+        or type_id == arrow::Type::LARGE_STRING or type_id == arrow::Type::LARGE_BINARY
+    );
+}
+
+/**
+ * Calls `visit_fn(offset, value)` for each non-null value of `chunk`, which must be a
+ * string or binary array, until `visit_fn` returns false. Returns false if stopped early.
+ */
+template <typename VisitFn>
+bool
+VisitBinaryValues(const Array &chunk, VisitFn &&visit_fn) {
+    auto visit_all = [&](const auto &binary_chunk) {
+        for (int64_t chunk_offset = 0; chunk_offset < binary_chunk.length(); ++chunk_offset) {
+            if (binary_chunk.IsNull(chunk_offset)) { continue; }
+            if (not visit_fn(chunk_offset, binary_chunk.GetView(chunk_offset))) { return false; }
+        }
+
+        return true;
+    };
+
+    auto type_id = chunk.type_id();
+    if (type_id == arrow::Type::LARGE_STRING or type_id == arrow::Type::LARGE_BINARY) {
+        return visit_all(static_cast<const LargeBinaryArray&>(chunk));
+    }
+
+    return visit_all(static_cast<const BinaryArray&>(chunk));
+}
+
+
+// >> Batched search
+
+/**
+ * Finds the first position in `source_arr` of every value in `search_vals`, in one scan.
+ * The result has one element per search value: its first index in `source_arr`, or -1 if
+ * it's absent (or null).
+ *
+ * The search values go into a hash table first. Then each row of `source_arr` is probed
+ * once, and the scan stops as soon as every distinct search value has been found. Looking
+ * up 500 values costs one scan (at most), rather than 500.
+ */
+Result<shared_ptr<Int64Array>>
+IndexOf(shared_ptr<ChunkedArray> source_arr, const Array &search_vals) {
+    if (not IsBinaryLike(*source_arr->type()) or not IsBinaryLike(*search_vals.type())) {
+        return Status::NotImplemented("Batched IndexOf expects string or binary arrays");
+    }
+
+    // >> Map each distinct search value to the positions it's at in `search_vals`
+    std::unordered_map<std::string_view, vector<int64_t>> search_positions;
+    VisitBinaryValues(
+         search_vals
+        ,[&](int64_t search_ndx, std::string_view search_val) {
+             search_positions[search_val].push_back(search_ndx);
+             return true;
+         }
+    );
+
+    vector<int64_t> first_indices(search_vals.length(), -1);
+    size_t          remaining = search_positions.size();
+
+    // >> Probe each row until every search value is found
+    int64_t chunk_start = 0;
+    for (const auto &chunk : source_arr->chunks()) {
+        if (remaining == 0) { break; }
+
+        VisitBinaryValues(
+             *chunk
+            ,[&](int64_t chunk_offset, std::string_view source_val) {
+                 auto match_iter = search_positions.find(source_val);
+                 if (match_iter == search_positions.end()) { return true; }
+
+                 // Erase the match, so later occurrences don't overwrite the first one
+                 for (int64_t search_ndx : match_iter->second) {
+                     first_indices[search_ndx] = chunk_start + chunk_offset;
+                 }
+
+                 search_positions.erase(match_iter);
+                 return --remaining > 0;
+             }
+        );
+
+        chunk_start += chunk->length();
+    }
+
+    Int64Builder result_builder;
+    ARROW_RETURN_NOT_OK(result_builder.AppendValues(first_indices));
+
+    ARROW_ASSIGN_OR_RAISE(auto result_arr, result_builder.Finish());
+    return std::static_pointer_cast<Int64Array>(result_arr);
+}
+
+
+// >> Parallel search
+
+/** How often (in rows) a worker checks whether an earlier range already has a match. */
+constexpr int64_t kCancelCheckRows = 1024;
+
+/**
+ * A range of rows in one chunk, searched by one worker. Ranges are numbered in row order,
+ * so a lower range index is always an earlier position in the column.
+ */
+struct SearchRange {
+    shared_ptr<Array> rows;
+    int64_t           row_start;
+};
+
+/**
+ * Like `IndexOf(source_arr, search_str)`, but searches ranges of rows concurrently on
+ * `ctx`'s executor (the CPU thread pool, by default). Chunks are split into ranges of at
+ * most `max_range_rows`, so that a column with few, large chunks still spreads out.
+ *
+ * Workers claim ranges in row order. When a worker finds a match, it records its range as
+ * the best one (if it's the lowest so far); workers on later ranges see that and stop,
+ * and later ranges aren't claimed. Ranges before the best one are always searched to the
+ * end, so the result is still the first occurrence.
+ */
+Result<int64_t>
+IndexOfParallel( shared_ptr<ChunkedArray>  source_arr
+                ,const string             &search_str
+                ,ExecContext              *ctx
+                ,int64_t                   max_range_rows) {
+    if (not IsBinaryLike(*source_arr->type())) {
+        return Status::NotImplemented("Parallel IndexOf expects a string or binary column");
+    }
+
+    if (max_range_rows <= 0) {
+        return Status::Invalid("max_range_rows must be positive, got ", max_range_rows);
+    }
+
+    if (ctx == nullptr) { ctx = arrow::compute::default_exec_context(); }
+
+    // >> Split the column into ranges, in row order
+    vector<SearchRange> search_ranges;
+    int64_t             chunk_start = 0;
+
+    for (const auto &chunk : source_arr->chunks()) {
+        for (int64_t range_start = 0; range_start < chunk->length(); range_start += max_range_rows) {
+            search_ranges.push_back({
+                 chunk->Slice(range_start, max_range_rows)
+                ,chunk_start + range_start
+            });
+        }
+
+        chunk_start += chunk->length();
+    }
+
+    int range_count = static_cast<int>(search_ranges.size());
+
+    // >> Each worker searches the next unclaimed range, until a lower range has a match
+    std::string_view     search_val   { search_str };
+    vector<int64_t>      range_hits    (range_count, -1);
+    std::atomic<int>     next_range   { 0 };
+    std::atomic<int>     best_range   { range_count };
+
+    auto RunWorker = [&](int) -> Status {
+        for (int range_ndx = next_range++; range_ndx < best_range.load(); range_ndx = next_range++) {
+            // Null rows aren't visited, so visited rows (not row offsets) are counted
+            int64_t visited_rows = 0;
+
+            VisitBinaryValues(
+                 *search_ranges[range_ndx].rows
+                ,[&](int64_t row_ndx, std::string_view source_val) {
+                     // Checking every row would make the workers contend for `best_range`
+                     if (    (++visited_rows % kCancelCheckRows) == 0
+                         and best_range.load(std::memory_order_relaxed) < range_ndx) {
+                         return false;
+                     }
+
+                     if (source_val != search_val) { return true; }
+
+                     range_hits[range_ndx] = row_ndx;
+
+                     int prev_best = best_range.load();
+                     while (    range_ndx < prev_best
+                            and not best_range.compare_exchange_weak(prev_best, range_ndx)) {}
+
+                     return false;
+                 }
+            );
+        }
+
+        return Status::OK();
+    };
+
+    auto thread_pool = ctx->executor();
+    if (thread_pool == nullptr) { thread_pool = arrow::internal::GetCpuThreadPool(); }
+
+    int worker_count = std::min(range_count, ctx->use_threads() ? thread_pool->GetCapacity() : 1);
+    ARROW_RETURN_NOT_OK(
+        arrow::internal::OptionalParallelFor(
+             ctx->use_threads()
+            ,worker_count
+            ,RunWorker
+            ,thread_pool
+        )
+    );
+
+    int found_range = best_range.load();
+    if (found_range == range_count) { return -1; }
+
+    return search_ranges[found_range].row_start + range_hits[found_range];
+}
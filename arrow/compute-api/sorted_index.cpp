@@ -0,0 +1,272 @@
+// ------------------------------
+// Dependencies
+
+// Local and third-party dependencies
+#include "recipe.hpp"
+#include "ordering.hpp"
+
+#include <algorithm>
+
+// ------------------------------
+// Macros and aliases
+
+using arrow::UInt64Array;
+using arrow::Int64Builder;
+
+
+// ------------------------------
+// Functions
+
+// >> Reading
+/** Reads the value at any row of a `ChunkedArray`, given where each chunk starts. */
+template <typename ArrowType>
+struct ChunkedReader {
+    using ArrayType = typename arrow::TypeTraits<ArrowType>::ArrayType;
+
+    const ChunkedArray    &source_arr;
+    const vector<int64_t> &chunk_starts;
+
+    auto
+    Value(int64_t row_ndx) const {
+        // The last chunk starting at or before `row_ndx` (so empty chunks are skipped)
+        auto chunk_iter = std::upper_bound(chunk_starts.begin(), chunk_starts.end(), row_ndx) - 1;
+        int  chunk_ndx  = static_cast<int>(chunk_iter - chunk_starts.begin());
+
+        const auto &chunk = static_cast<const ArrayType&>(*source_arr.chunk(chunk_ndx));
+        return chunk.GetView(row_ndx - *chunk_iter);
+    }
+};
+
+
+// >> Sort detection
+/**
+ * True if the non-null values of `source_arr` are ascending and nulls (if any) are last,
+ * which is the order `SortIndices` would put them in.
+ */
+template <typename ArrowType>
+bool
+IsColumnSorted(const ChunkedArray &source_arr) {
+    using ArrayType = typename arrow::TypeTraits<ArrowType>::ArrayType;
+    using ValueType = decltype(std::declval<ArrayType>().GetView(0));
+
+    ValueType prev_val   {};
+    bool      has_prev   = false;
+    bool      seen_nulls = false;
+
+    for (const auto &chunk : source_arr.chunks()) {
+        const auto &typed_chunk = static_cast<const ArrayType&>(*chunk);
+        bool        has_nulls   = typed_chunk.null_count() > 0;
+
+        for (int64_t chunk_offset = 0; chunk_offset < typed_chunk.length(); ++chunk_offset) {
+            if (has_nulls and typed_chunk.IsNull(chunk_offset)) { seen_nulls = true; continue; }
+            if (seen_nulls)                                      { return false;                }
+
+            ValueType chunk_val = typed_chunk.GetView(chunk_offset);
+            if (has_prev and SortsBefore(chunk_val, prev_val)) { return false; }
+
+            prev_val = chunk_val;
+            has_prev = true;
+        }
+    }
+
+    return true;
+}
+
+
+// >> Binary search
+/**
+ * Returns the first position in `[0, sorted_length)` whose value doesn't sort before
+ * `search_key`, where `row_at(pos)` is the row at a sorted position.
+ */
+template <typename ArrowType, typename KeyType, typename RowFn>
+int64_t
+LowerBound( const ChunkedReader<ArrowType> &reader
+           ,int64_t                         sorted_length
+           ,const KeyType                  &search_key
+           ,RowFn                         &&row_at) {
+    int64_t low_ndx  = 0;
+    int64_t high_ndx = sorted_length;
+
+    while (low_ndx < high_ndx) {
+        int64_t mid_ndx = low_ndx + (high_ndx - low_ndx) / 2;
+
+        if (SortsBefore<KeyType>(reader.Value(row_at(mid_ndx)), search_key)) {
+            low_ndx = mid_ndx + 1;
+        }
+
+        else {
+            high_ndx = mid_ndx;
+        }
+    }
+
+    return low_ndx;
+}
+
+
+// ------------------------------
+// Classes
+
+Result<std::unique_ptr<SortedIndex>>
+SortedIndex::Build(shared_ptr<ChunkedArray> source_arr, bool is_sorted) {
+    std::unique_ptr<SortedIndex> sorted_index { new SortedIndex };
+    sorted_index->assume_sorted = is_sorted;
+
+    ARROW_RETURN_NOT_OK(sorted_index->Refresh(std::move(source_arr)));
+    return sorted_index;
+}
+
+bool
+SortedIndex::IsCurrent(const ChunkedArray &source_arr) const {
+    return indexed_arr != nullptr and HasSameChunks(*indexed_arr, source_arr);
+}
+
+/**
+ * Unlike a `ValueIndex`, there's no cheap update when chunks are appended (new values can
+ * sort anywhere), so a stale index is rebuilt.
+ */
+Status
+SortedIndex::Refresh(shared_ptr<ChunkedArray> source_arr) {
+    if (source_arr == nullptr) {
+        return Status::Invalid("Cannot index a null ChunkedArray");
+    }
+
+    if (IsCurrent(*source_arr)) { return Status::OK(); }
+
+    indexed_arr = std::move(source_arr);
+    return IndexChunks();
+}
+
+Status
+SortedIndex::IndexChunks() {
+    chunk_starts.clear();
+
+    int64_t chunk_start = 0;
+    for (const auto &chunk : indexed_arr->chunks()) {
+        chunk_starts.push_back(chunk_start);
+        chunk_start += chunk->length();
+    }
+
+    sorted_length = indexed_arr->length() - indexed_arr->null_count();
+    sort_indices  = nullptr;
+
+    // >> Search in place if the column is sorted (or we're told it is)
+    bool is_sorted = assume_sorted;
+    ARROW_RETURN_NOT_OK(VisitOrderedType(
+         *indexed_arr->type()
+        ,[&](const auto &arrow_type) {
+             using ArrowType = std::decay_t<decltype(arrow_type)>;
+
+             if (not is_sorted) { is_sorted = IsColumnSorted<ArrowType>(*indexed_arr); }
+             return Status::OK();
+         }
+    ));
+
+    if (is_sorted) { return Status::OK(); }
+
+    // >> Otherwise, sort once; nulls go last, so the first `sorted_length` are searchable
+    ARROW_ASSIGN_OR_RAISE(auto sort_arr, arrow::compute::SortIndices(*indexed_arr));
+    sort_indices = std::static_pointer_cast<UInt64Array>(sort_arr);
+
+    return Status::OK();
+}
+
+int64_t
+SortedIndex::RowAt(int64_t sorted_ndx) const {
+    if (sort_indices == nullptr) { return sorted_ndx; }
+
+    return static_cast<int64_t>(sort_indices->Value(sorted_ndx));
+}
+
+/**
+ * Binary search finds the first sorted position of `search_val`. In place, that's the
+ * first occurrence; through the sort permutation, it's the first occurrence because the
+ * sort is stable (equal values keep their order).
+ */
+Result<int64_t>
+SortedIndex::Lookup(shared_ptr<Scalar> search_val) const {
+    if (search_val == nullptr or not search_val->is_valid) { return -1; }
+
+    ARROW_ASSIGN_OR_RAISE(search_val, CastToColumnType(search_val, indexed_arr->type()));
+    if (not search_val->is_valid) { return -1; }
+
+    int64_t found_ndx = -1;
+    ARROW_RETURN_NOT_OK(VisitOrderedType(
+         *indexed_arr->type()
+        ,[&](const auto &arrow_type) {
+             using ArrowType = std::decay_t<decltype(arrow_type)>;
+
+             ChunkedReader<ArrowType> reader      { *indexed_arr, chunk_starts };
+             auto                     search_key  = ScalarKey<ArrowType>(*search_val);
+             auto                     row_at      = [this](int64_t ndx) { return RowAt(ndx); };
+
+             int64_t sorted_ndx = LowerBound(reader, sorted_length, search_key, row_at);
+             if (    sorted_ndx < sorted_length
+                 and reader.Value(RowAt(sorted_ndx)) == search_key) {
+                 found_ndx = RowAt(sorted_ndx);
+             }
+
+             return Status::OK();
+         }
+    ));
+
+    return found_ndx;
+}
+
+Result<shared_ptr<Int64Array>>
+SortedIndex::Range(shared_ptr<Scalar> lower_val, shared_ptr<Scalar> upper_val) const {
+    if (    lower_val == nullptr or not lower_val->is_valid
+        or  upper_val == nullptr or not upper_val->is_valid) {
+        return Status::Invalid("Range bounds must not be null");
+    }
+
+    ARROW_ASSIGN_OR_RAISE(lower_val, CastToColumnType(lower_val, indexed_arr->type()));
+    ARROW_ASSIGN_OR_RAISE(upper_val, CastToColumnType(upper_val, indexed_arr->type()));
+
+    int64_t range_start = 0;
+    int64_t range_end   = 0;
+    ARROW_RETURN_NOT_OK(VisitOrderedType(
+         *indexed_arr->type()
+        ,[&](const auto &arrow_type) {
+             using ArrowType = std::decay_t<decltype(arrow_type)>;
+
+             ChunkedReader<ArrowType> reader { *indexed_arr, chunk_starts };
+             auto                     row_at = [this](int64_t ndx) { return RowAt(ndx); };
+
+             range_start = LowerBound(
+                reader, sorted_length, ScalarKey<ArrowType>(*lower_val), row_at
+             );
+
+             range_end   = LowerBound(
+                reader, sorted_length, ScalarKey<ArrowType>(*upper_val), row_at
+             );
+
+             return Status::OK();
+         }
+    ));
+
+    Int64Builder range_builder;
+    ARROW_RETURN_NOT_OK(range_builder.Reserve(std::max<int64_t>(range_end - range_start, 0)));
+
+    for (int64_t sorted_ndx = range_start; sorted_ndx < range_end; ++sorted_ndx) {
+        range_builder.UnsafeAppend(RowAt(sorted_ndx));
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto range_arr, range_builder.Finish());
+    return std::static_pointer_cast<Int64Array>(range_arr);
+}
+
+
+// ------------------------------
+// Functions
+
+/**
+ * Like `IndexOf(source_arr, search_val)`, but answers by binary search with `sorted_index`.
+ * If `source_arr` isn't the column the index was built from, the index is rebuilt first.
+ */
+Result<int64_t>
+IndexOf( shared_ptr<ChunkedArray>  source_arr
+        ,shared_ptr<Scalar>        search_val
+        ,SortedIndex              *sorted_index) {
+    ARROW_RETURN_NOT_OK(sorted_index->Refresh(source_arr));
+    return sorted_index->Lookup(std::move(search_val));
+}
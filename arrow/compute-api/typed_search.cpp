@@ -0,0 +1,450 @@
+// ------------------------------
+// Dependencies
+
+// Local and third-party dependencies
+#include "recipe.hpp"
+
+#include <cstring>
+#include <type_traits>
+#include <arrow/util/cpu_info.h>
+#include <arrow/visit_type_inline.h>
+
+// x86 kernels are compiled with per-function target attributes, so this file doesn't need
+// `-mavx2` and the binary still runs on older CPUs.
+#if defined(__GNUC__) and defined(__x86_64__)
+    #define SEARCH_X86_SIMD 1
+    #include <immintrin.h>
+#else
+    #define SEARCH_X86_SIMD 0
+#endif
+
+
+// ------------------------------
+// Macros and aliases
+
+using arrow::DataType;
+using arrow::BooleanArray;
+using arrow::internal::CpuInfo;
+
+
+// ------------------------------
+// Functions
+
+// >> Fixed-width loops
+/**
+ * Finds the first position in `[start_ndx, end_ndx)` where `vals` equals `search_val` and
+ * `is_valid_fn` agrees. Null slots can hold anything, so a match is only a candidate.
+ */
+template <typename CType, typename ValidFn>
+int64_t
+FindFixedLoop( const CType *vals
+              ,int64_t      start_ndx
+              ,int64_t      end_ndx
+              ,CType        search_val
+              ,ValidFn     &&is_valid_fn) {
+    for (int64_t ndx = start_ndx; ndx < end_ndx; ++ndx) {
+        if (vals[ndx] == search_val and is_valid_fn(ndx)) { return ndx; }
+    }
+
+    return -1;
+}
+
+#if SEARCH_X86_SIMD
+/**
+ * Calls `match_fn(ndx)` for each lane set in `candidate_bits` (lowest first), where a lane
+ * is `lane_bits` bits of the mask and lane `i` stands for position `first_ndx + i`. Returns
+ * the first position `match_fn` accepts, or -1.
+ */
+template <typename MatchFn>
+int64_t
+FirstMatchingCandidate( uint32_t   candidate_bits
+                       ,int        lane_bits
+                       ,int64_t    first_ndx
+                       ,MatchFn  &&match_fn) {
+    uint64_t remaining_bits = candidate_bits;
+
+    while (remaining_bits != 0) {
+        int     lane_ndx      = __builtin_ctzll(remaining_bits) / lane_bits;
+        int64_t candidate_ndx = first_ndx + lane_ndx;
+        if (match_fn(candidate_ndx)) { return candidate_ndx; }
+
+        // Clear this lane (and any below it)
+        remaining_bits &= ~((uint64_t { 1 } << ((lane_ndx + 1) * lane_bits)) - 1);
+    }
+
+    return -1;
+}
+
+/**
+ * Broadcasts `search_val` into a 256-bit register, compares 32 bytes of `vals` at a time
+ * and turns the comparison into a bit mask. `movemask_epi8` gives one bit per byte, so an
+ * integer lane is `sizeof(CType)` bits of the mask. Floats use ordered comparison,
+ * so that NaN never matches (as with `==`).
+ */
+template <typename CType, typename ValidFn>
+__attribute__((target("avx2")))
+int64_t
+FindFixedAvx2( const CType *vals
+              ,int64_t      end_ndx
+              ,CType        search_val
+              ,ValidFn     &&is_valid_fn) {
+    constexpr int64_t lane_count = 32 / sizeof(CType);
+
+    int64_t ndx = 0;
+    for (; ndx + lane_count <= end_ndx; ndx += lane_count) {
+        uint32_t match_bits;
+        int      lane_bits = 1;
+
+        if constexpr (std::is_same<CType, float>::value) {
+            __m256 cmp_vals = _mm256_cmp_ps(
+                 _mm256_loadu_ps(vals + ndx)
+                ,_mm256_set1_ps(search_val)
+                ,_CMP_EQ_OQ
+            );
+
+            match_bits = static_cast<uint32_t>(_mm256_movemask_ps(cmp_vals));
+        }
+
+        else if constexpr (std::is_same<CType, double>::value) {
+            __m256d cmp_vals = _mm256_cmp_pd(
+                 _mm256_loadu_pd(vals + ndx)
+                ,_mm256_set1_pd(search_val)
+                ,_CMP_EQ_OQ
+            );
+
+            match_bits = static_cast<uint32_t>(_mm256_movemask_pd(cmp_vals));
+        }
+
+        else {
+            __m256i chunk_vals = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vals + ndx));
+            __m256i cmp_vals;
+
+            if constexpr (sizeof(CType) == 1) {
+                cmp_vals = _mm256_cmpeq_epi8(chunk_vals, _mm256_set1_epi8(search_val));
+            }
+            else if constexpr (sizeof(CType) == 2) {
+                cmp_vals = _mm256_cmpeq_epi16(chunk_vals, _mm256_set1_epi16(search_val));
+            }
+            else if constexpr (sizeof(CType) == 4) {
+                cmp_vals = _mm256_cmpeq_epi32(chunk_vals, _mm256_set1_epi32(search_val));
+            }
+            else {
+                cmp_vals = _mm256_cmpeq_epi64(chunk_vals, _mm256_set1_epi64x(search_val));
+            }
+
+            match_bits = static_cast<uint32_t>(_mm256_movemask_epi8(cmp_vals));
+            lane_bits  = sizeof(CType);
+        }
+
+        if (match_bits == 0) { continue; }
+
+        int64_t match_ndx = FirstMatchingCandidate(match_bits, lane_bits, ndx, is_valid_fn);
+        if (match_ndx >= 0) { return match_ndx; }
+    }
+
+    return FindFixedLoop(vals, ndx, end_ndx, search_val, is_valid_fn);
+}
+#endif
+
+/** Finds `search_val` in one chunk of a fixed-width column; returns its offset, or -1. */
+template <typename CType>
+int64_t
+FindFixed(const Array &chunk, CType search_val) {
+    const CType *vals = chunk.data()->GetValues<CType>(1);
+
+    auto is_valid_fn = [&](int64_t ndx) { return chunk.IsValid(ndx); };
+    auto all_valid   = [](int64_t)      { return true;                };
+
+    #if SEARCH_X86_SIMD
+        if (CpuInfo::GetInstance()->IsSupported(CpuInfo::AVX2)) {
+            if (chunk.null_count() == 0) {
+                return FindFixedAvx2(vals, chunk.length(), search_val, all_valid);
+            }
+
+            return FindFixedAvx2(vals, chunk.length(), search_val, is_valid_fn);
+        }
+    #endif
+
+    if (chunk.null_count() == 0) {
+        return FindFixedLoop(vals, 0, chunk.length(), search_val, all_valid);
+    }
+
+    return FindFixedLoop(vals, 0, chunk.length(), search_val, is_valid_fn);
+}
+
+
+// >> Variable-width loops
+/**
+ * Only values with the same length as `search_val` can match, and lengths are the
+ * differences between adjacent offsets, so the offsets are checked before any value bytes.
+ */
+template <typename OffsetType, typename MatchFn>
+int64_t
+FindBinaryLoop( const OffsetType *offsets
+               ,int64_t           start_ndx
+               ,int64_t           end_ndx
+               ,OffsetType        search_len
+               ,MatchFn         &&match_fn) {
+    for (int64_t ndx = start_ndx; ndx < end_ndx; ++ndx) {
+        if (offsets[ndx + 1] - offsets[ndx] == search_len and match_fn(ndx)) { return ndx; }
+    }
+
+    return -1;
+}
+
+#if SEARCH_X86_SIMD
+/**
+ * Computes 8 (or 4, for 64-bit offsets) value lengths at a time by subtracting the offsets
+ * from the offsets one position later, then compares them to the length of `search_val`.
+ * Only positions with equal lengths go to `match_fn`, which compares bytes.
+ */
+template <typename OffsetType, typename MatchFn>
+__attribute__((target("avx2")))
+int64_t
+FindBinaryAvx2( const OffsetType *offsets
+               ,int64_t           end_ndx
+               ,OffsetType        search_len
+               ,MatchFn         &&match_fn) {
+    constexpr int64_t lane_count = 32 / sizeof(OffsetType);
+
+    int64_t ndx = 0;
+    for (; ndx + lane_count <= end_ndx; ndx += lane_count) {
+        auto starts = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(offsets + ndx));
+        auto ends   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(offsets + ndx + 1));
+        uint32_t candidate_bits;
+
+        if constexpr (sizeof(OffsetType) == 4) {
+            auto cmp_lens  = _mm256_cmpeq_epi32(
+                 _mm256_sub_epi32(ends, starts)
+                ,_mm256_set1_epi32(search_len)
+            );
+
+            candidate_bits = _mm256_movemask_ps(_mm256_castsi256_ps(cmp_lens));
+        }
+
+        else {
+            auto cmp_lens  = _mm256_cmpeq_epi64(
+                 _mm256_sub_epi64(ends, starts)
+                ,_mm256_set1_epi64x(search_len)
+            );
+
+            candidate_bits = _mm256_movemask_pd(_mm256_castsi256_pd(cmp_lens));
+        }
+
+        if (candidate_bits == 0) { continue; }
+
+        int64_t match_ndx = FirstMatchingCandidate(candidate_bits, 1, ndx, match_fn);
+        if (match_ndx >= 0) { return match_ndx; }
+    }
+
+    return FindBinaryLoop(offsets, ndx, end_ndx, search_len, match_fn);
+}
+#endif
+
+/** Finds `search_val` in one chunk of a string or binary column; returns its offset, or -1. */
+template <typename OffsetType>
+int64_t
+FindBinary(const Array &chunk, std::string_view search_val) {
+    const auto *offsets    = chunk.data()->GetValues<OffsetType>(1);
+    const auto *value_data = chunk.data()->buffers[2] ? chunk.data()->buffers[2]->data() : nullptr;
+    auto        search_len = static_cast<OffsetType>(search_val.size());
+
+    // Offsets index into the whole data buffer, so the array's offset doesn't apply to it.
+    // Values often share a prefix (e.g. "gene_..."), so the last byte is checked first.
+    auto bytes_match = [&](int64_t ndx) {
+        if (search_len == 0) { return true; }
+
+        const uint8_t *candidate = value_data + offsets[ndx];
+        return (
+                candidate[search_len - 1] == static_cast<uint8_t>(search_val.back())
+            and std::memcmp(candidate, search_val.data(), search_len) == 0
+        );
+    };
+
+    auto match_fn = [&](int64_t ndx) { return bytes_match(ndx) and chunk.IsValid(ndx); };
+
+    #if SEARCH_X86_SIMD
+        if (CpuInfo::GetInstance()->IsSupported(CpuInfo::AVX2)) {
+            if (chunk.null_count() == 0) {
+                return FindBinaryAvx2(offsets, chunk.length(), search_len, bytes_match);
+            }
+
+            return FindBinaryAvx2(offsets, chunk.length(), search_len, match_fn);
+        }
+    #endif
+
+    if (chunk.null_count() == 0) {
+        return FindBinaryLoop(offsets, 0, chunk.length(), search_len, bytes_match);
+    }
+
+    return FindBinaryLoop(offsets, 0, chunk.length(), search_len, match_fn);
+}
+
+
+// >> Dispatch
+/**
+ * Returns the first position in `source_arr` where `find_fn(chunk)` finds a match (the
+ * offset within the chunk), or -1. Chunks that `zone_map` (if any) rules out for
+ * `search_val` aren't searched.
+ */
+template <typename FindFn>
+int64_t
+FindInChunks( const ChunkedArray &source_arr
+             ,const ZoneMap      *zone_map
+             ,const Scalar       &search_val
+             ,FindFn            &&find_fn) {
+    int64_t chunk_start = 0;
+
+    for (int chunk_ndx = 0; chunk_ndx < source_arr.num_chunks(); ++chunk_ndx) {
+        const auto &chunk = source_arr.chunk(chunk_ndx);
+
+        if (zone_map == nullptr or zone_map->MayContain(chunk_ndx, search_val)) {
+            int64_t chunk_offset = find_fn(*chunk);
+            if (chunk_offset >= 0) { return chunk_start + chunk_offset; }
+        }
+
+        chunk_start += chunk->length();
+    }
+
+    return -1;
+}
+
+/**
+ * Picks a search loop for the column's type at compile time, via `arrow::VisitTypeInline`.
+ * Temporal types are searched as the integers they're stored as.
+ */
+struct TypedSearch {
+    const ChunkedArray &source_arr;
+    const Scalar       &search_val;
+    const ZoneMap      *zone_map;
+    int64_t             found_ndx;
+
+    template <typename ArrowType>
+    arrow::enable_if_t<
+         arrow::is_number_type<ArrowType>::value or arrow::is_temporal_type<ArrowType>::value
+        ,Status
+    >
+    Visit(const ArrowType &) {
+        using CType      = typename ArrowType::c_type;
+        using ScalarType = typename arrow::TypeTraits<ArrowType>::ScalarType;
+
+        // e.g. day-time intervals are structs, which can't be compared in a vector register
+        if constexpr (not std::is_arithmetic<CType>::value) {
+            return Status::NotImplemented("IndexOf does not support ", *source_arr.type());
+        }
+
+        else {
+            CType search_cval = static_cast<const ScalarType&>(search_val).value;
+            found_ndx = FindInChunks(
+                 source_arr
+                ,zone_map
+                ,search_val
+                ,[&](const Array &chunk) { return FindFixed<CType>(chunk, search_cval); }
+            );
+
+            return Status::OK();
+        }
+    }
+
+    template <typename ArrowType>
+    arrow::enable_if_base_binary<ArrowType, Status>
+    Visit(const ArrowType &) {
+        using OffsetType = typename ArrowType::offset_type;
+
+        const auto       &binary_scalar = static_cast<const arrow::BaseBinaryScalar&>(search_val);
+        std::string_view  search_view {
+             reinterpret_cast<const char*>(binary_scalar.value->data())
+            ,static_cast<size_t>(binary_scalar.value->size())
+        };
+
+        found_ndx = FindInChunks(
+             source_arr
+            ,zone_map
+            ,search_val
+            ,[&](const Array &chunk) { return FindBinary<OffsetType>(chunk, search_view); }
+        );
+
+        return Status::OK();
+    }
+
+    Status
+    Visit(const arrow::BooleanType &) {
+        bool search_bval = static_cast<const arrow::BooleanScalar&>(search_val).value;
+
+        found_ndx = FindInChunks(
+             source_arr
+            ,zone_map
+            ,search_val
+            ,[&](const Array &chunk) -> int64_t {
+                 const auto &bool_chunk = static_cast<const BooleanArray&>(chunk);
+
+                 for (int64_t ndx = 0; ndx < bool_chunk.length(); ++ndx) {
+                     if (bool_chunk.IsValid(ndx) and bool_chunk.Value(ndx) == search_bval) {
+                         return ndx;
+                     }
+                 }
+
+                 return -1;
+             }
+        );
+
+        return Status::OK();
+    }
+
+    // Comparing half floats as bits would get -0.0 and NaN wrong
+    Status
+    Visit(const arrow::HalfFloatType &) {
+        return Status::NotImplemented("IndexOf does not support ", *source_arr.type());
+    }
+
+    Status
+    Visit(const DataType &) {
+        return Status::NotImplemented("IndexOf does not support ", *source_arr.type());
+    }
+};
+
+/**
+ * Casts `search_val` to `col_type`, if it's another type, so that it can be compared with
+ * the column's values.
+ */
+Result<shared_ptr<Scalar>>
+CastToColumnType(shared_ptr<Scalar> search_val, const shared_ptr<DataType> &col_type) {
+    if (search_val->type->Equals(*col_type)) { return search_val; }
+
+    ARROW_ASSIGN_OR_RAISE(Datum cast_val, arrow::compute::Cast(Datum(search_val), col_type));
+    return cast_val.scalar();
+}
+
+/**
+ * Like `IndexOf(source_arr, search_str)`, for a primitive, string or binary column. The
+ * search value is cast to the column's type, if needed; a null search value is never found.
+ *
+ * Unlike `Index`, which compares each value as a boxed scalar, each type gets its own
+ * (vectorized, where AVX2 is available) loop over the column's buffers.
+ */
+Result<int64_t>
+IndexOf(shared_ptr<ChunkedArray> source_arr, shared_ptr<Scalar> search_val) {
+    return IndexOf(std::move(source_arr), std::move(search_val), static_cast<ZoneMap*>(nullptr));
+}
+
+/**
+ * Like `IndexOf(source_arr, search_val)`, but only searches chunks whose statistics in
+ * `zone_map` (if not null) allow `search_val`. If `source_arr` isn't the column the zone
+ * map was built from, it's refreshed first.
+ */
+Result<int64_t>
+IndexOf( shared_ptr<ChunkedArray>  source_arr
+        ,shared_ptr<Scalar>        search_val
+        ,ZoneMap                  *zone_map) {
+    if (search_val == nullptr or not search_val->is_valid) { return -1; }
+
+    ARROW_ASSIGN_OR_RAISE(search_val, CastToColumnType(search_val, source_arr->type()));
+    if (not search_val->is_valid) { return -1; }
+
+    if (zone_map != nullptr) { ARROW_RETURN_NOT_OK(zone_map->Refresh(source_arr)); }
+
+    TypedSearch typed_search { *source_arr, *search_val, zone_map, -1 };
+    ARROW_RETURN_NOT_OK(arrow::VisitTypeInline(*source_arr->type(), &typed_search));
+
+    return typed_search.found_ndx;
+}
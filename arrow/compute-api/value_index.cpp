@@ -0,0 +1,169 @@
+// ------------------------------
+// Dependencies
+
+// Local and third-party dependencies
+#include "recipe.hpp"
+
+// ------------------------------
+// Macros and aliases
+
+using arrow::BinaryArray;
+using arrow::LargeBinaryArray;
+
+
+// ------------------------------
+// Functions
+
+/**
+ * True if both arrays have the same `ArrayData` for every chunk. Arrays are immutable, so
+ * that means the same values; this doesn't compare any values.
+ */
+bool
+HasSameChunks(const ChunkedArray &left_arr, const ChunkedArray &right_arr) {
+    if (left_arr.num_chunks() != right_arr.num_chunks()) { return false; }
+
+    for (int chunk_ndx = 0; chunk_ndx < left_arr.num_chunks(); ++chunk_ndx) {
+        if (left_arr.chunk(chunk_ndx)->data() != right_arr.chunk(chunk_ndx)->data()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * The number of leading chunks that have the same `ArrayData` in both arrays (none if the
+ * types differ). If it's every chunk of `left_arr`, `right_arr` only appended to it.
+ */
+int
+CountSameLeadingChunks(const ChunkedArray &left_arr, const ChunkedArray &right_arr) {
+    if (not left_arr.type()->Equals(*right_arr.type())) { return 0; }
+
+    int max_same    = std::min(left_arr.num_chunks(), right_arr.num_chunks());
+    int same_chunks = 0;
+
+    while (    same_chunks < max_same
+           and left_arr.chunk(same_chunks)->data() == right_arr.chunk(same_chunks)->data()) {
+        ++same_chunks;
+    }
+
+    return same_chunks;
+}
+
+/**
+ * Adds each non-null value of `chunk` to `first_locations`, unless an earlier position of
+ * the value is already there. `BinaryArray` also covers `StringArray` (and the large
+ * variants are the same with 64-bit offsets).
+ */
+template <typename BinaryArrayType>
+void
+IndexBinaryChunk( const BinaryArrayType                               &chunk
+                 ,int                                                  chunk_ndx
+                 ,std::unordered_map<std::string_view, ChunkLocation> *first_locations) {
+    for (int64_t chunk_offset = 0; chunk_offset < chunk.length(); ++chunk_offset) {
+        if (chunk.IsNull(chunk_offset)) { continue; }
+
+        // `emplace` does nothing if the value was seen before, so the first position wins
+        first_locations->emplace(
+             chunk.GetView(chunk_offset)
+            ,ChunkLocation { chunk_ndx, chunk_offset }
+        );
+    }
+}
+
+
+// ------------------------------
+// Classes
+
+Result<std::unique_ptr<ValueIndex>>
+ValueIndex::Build(shared_ptr<ChunkedArray> source_arr) {
+    std::unique_ptr<ValueIndex> value_index { new ValueIndex };
+    ARROW_RETURN_NOT_OK(value_index->Refresh(std::move(source_arr)));
+
+    return value_index;
+}
+
+bool
+ValueIndex::IsCurrent(const ChunkedArray &source_arr) const {
+    return indexed_arr != nullptr and HasSameChunks(*indexed_arr, source_arr);
+}
+
+/**
+ * If `source_arr` starts with the chunks that are already indexed (e.g. batches were
+ * appended to a table), only the new chunks are indexed. Otherwise, the index is rebuilt.
+ */
+Status
+ValueIndex::Refresh(shared_ptr<ChunkedArray> source_arr) {
+    if (source_arr == nullptr) {
+        return Status::Invalid("Cannot index a null ChunkedArray");
+    }
+
+    auto type_id = source_arr->type()->id();
+    if (    type_id != arrow::Type::STRING       and type_id != arrow::Type::BINARY
+        and type_id != arrow::Type::LARGE_STRING and type_id != arrow::Type::LARGE_BINARY) {
+        return Status::NotImplemented("ValueIndex only indexes string or binary columns");
+    }
+
+    // >> Find how many leading chunks are unchanged
+    int same_chunks = (
+        (indexed_arr != nullptr) ? CountSameLeadingChunks(*indexed_arr, *source_arr) : 0
+    );
+
+    bool is_append = indexed_arr != nullptr and same_chunks == indexed_arr->num_chunks();
+    if (not is_append) {
+        first_locations.clear();
+        chunk_starts.clear();
+        same_chunks = 0;
+    }
+
+    indexed_arr = std::move(source_arr);
+    return IndexChunks(same_chunks);
+}
+
+Status
+ValueIndex::IndexChunks(int first_chunk_ndx) {
+    int64_t chunk_start = chunk_starts.empty() ? 0 : (
+        chunk_starts.back() + indexed_arr->chunk(first_chunk_ndx - 1)->length()
+    );
+
+    bool is_large = (
+           indexed_arr->type()->id() == arrow::Type::LARGE_STRING
+        or indexed_arr->type()->id() == arrow::Type::LARGE_BINARY
+    );
+
+    for (int chunk_ndx = first_chunk_ndx; chunk_ndx < indexed_arr->num_chunks(); ++chunk_ndx) {
+        const auto &chunk = indexed_arr->chunk(chunk_ndx);
+
+        chunk_starts.push_back(chunk_start);
+        chunk_start += chunk->length();
+
+        if (is_large) {
+            const auto &binary_chunk = static_cast<const LargeBinaryArray&>(*chunk);
+            IndexBinaryChunk(binary_chunk, chunk_ndx, &first_locations);
+        }
+
+        else {
+            const auto &binary_chunk = static_cast<const BinaryArray&>(*chunk);
+            IndexBinaryChunk(binary_chunk, chunk_ndx, &first_locations);
+        }
+    }
+
+    return Status::OK();
+}
+
+bool
+ValueIndex::Locate(std::string_view search_val, ChunkLocation *location) const {
+    auto location_iter = first_locations.find(search_val);
+    if (location_iter == first_locations.end()) { return false; }
+
+    *location = location_iter->second;
+    return true;
+}
+
+int64_t
+ValueIndex::Lookup(std::string_view search_val) const {
+    ChunkLocation location;
+    if (not Locate(search_val, &location)) { return -1; }
+
+    return chunk_starts[location.chunk_ndx] + location.chunk_offset;
+}
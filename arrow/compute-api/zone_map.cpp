@@ -0,0 +1,181 @@
+// ------------------------------
+// Dependencies
+
+// Local and third-party dependencies
+#include "recipe.hpp"
+#include "ordering.hpp"
+
+// ------------------------------
+// Macros and aliases
+
+using arrow::DataType;
+
+
+// ------------------------------
+// Functions
+
+/**
+ * Finds the min and max non-null values of `chunk`, skipping NaN (which has no place in a
+ * range). Leaves `chunk_stats` untouched if there are none.
+ */
+template <typename ArrowType>
+Status
+ChunkMinMax( const Array                &chunk
+            ,const shared_ptr<DataType> &col_type
+            ,ChunkStatistics            *chunk_stats) {
+    using ArrayType = typename arrow::TypeTraits<ArrowType>::ArrayType;
+    using ValueType = decltype(std::declval<ArrayType>().GetView(0));
+
+    const auto &typed_chunk = static_cast<const ArrayType&>(chunk);
+    bool        has_nulls   = typed_chunk.null_count() > 0;
+    bool        has_vals    = false;
+    ValueType   min_val {};
+    ValueType   max_val {};
+
+    for (int64_t chunk_offset = 0; chunk_offset < typed_chunk.length(); ++chunk_offset) {
+        if (has_nulls and typed_chunk.IsNull(chunk_offset)) { continue; }
+
+        ValueType chunk_val = typed_chunk.GetView(chunk_offset);
+        if constexpr (std::is_floating_point<ValueType>::value) {
+            if (std::isnan(chunk_val)) { continue; }
+        }
+
+        if (not has_vals) {
+            min_val  = chunk_val;
+            max_val  = chunk_val;
+            has_vals = true;
+        }
+
+        else if (chunk_val < min_val) { min_val = chunk_val; }
+        else if (max_val < chunk_val) { max_val = chunk_val; }
+    }
+
+    if (not has_vals) { return Status::OK(); }
+
+    // Binary values are copied, so the statistics don't point into the chunk's buffers
+    if constexpr (arrow::is_base_binary_type<ArrowType>::value) {
+        ARROW_ASSIGN_OR_RAISE(
+             chunk_stats->min_val
+            ,arrow::MakeScalar(col_type, arrow::Buffer::FromString(string { min_val }))
+        );
+
+        ARROW_ASSIGN_OR_RAISE(
+             chunk_stats->max_val
+            ,arrow::MakeScalar(col_type, arrow::Buffer::FromString(string { max_val }))
+        );
+    }
+
+    else {
+        ARROW_ASSIGN_OR_RAISE(chunk_stats->min_val, arrow::MakeScalar(col_type, min_val));
+        ARROW_ASSIGN_OR_RAISE(chunk_stats->max_val, arrow::MakeScalar(col_type, max_val));
+    }
+
+    return Status::OK();
+}
+
+
+// ------------------------------
+// Classes
+
+Result<std::unique_ptr<ZoneMap>>
+ZoneMap::Build(shared_ptr<ChunkedArray> source_arr) {
+    std::unique_ptr<ZoneMap> zone_map { new ZoneMap };
+    ARROW_RETURN_NOT_OK(zone_map->Refresh(std::move(source_arr)));
+
+    return zone_map;
+}
+
+bool
+ZoneMap::IsCurrent(const ChunkedArray &source_arr) const {
+    return indexed_arr != nullptr and HasSameChunks(*indexed_arr, source_arr);
+}
+
+/**
+ * If `source_arr` starts with the chunks that already have statistics (e.g. batches were
+ * appended to a table), only the new chunks are scanned. Otherwise, every chunk is.
+ */
+Status
+ZoneMap::Refresh(shared_ptr<ChunkedArray> source_arr) {
+    if (source_arr == nullptr) {
+        return Status::Invalid("Cannot compute statistics of a null ChunkedArray");
+    }
+
+    // Types that can't be ordered (e.g. boolean) only get null counts, and no chunk of
+    // theirs is ever ruled out
+    is_ordered = VisitOrderedType(
+         *source_arr->type()
+        ,[](const auto &) { return Status::OK(); }
+    ).ok();
+
+    // >> Find how many leading chunks are unchanged
+    int same_chunks = (
+        (indexed_arr != nullptr) ? CountSameLeadingChunks(*indexed_arr, *source_arr) : 0
+    );
+
+    stats_by_chunk.resize(same_chunks);
+    indexed_arr = std::move(source_arr);
+
+    return ComputeStatistics(same_chunks);
+}
+
+/**
+ * Statistics for each chunk from `first_chunk_ndx` on, from `ChunkMinMax`; earlier chunks
+ * keep the statistics they already have.
+ */
+Status
+ZoneMap::ComputeStatistics(int first_chunk_ndx) {
+    const auto &col_type = indexed_arr->type();
+
+    for (int chunk_ndx = first_chunk_ndx; chunk_ndx < indexed_arr->num_chunks(); ++chunk_ndx) {
+        const auto      &chunk       = indexed_arr->chunk(chunk_ndx);
+        ChunkStatistics  chunk_stats { nullptr, nullptr, chunk->null_count() };
+
+        if (not is_ordered) {
+            stats_by_chunk.push_back(std::move(chunk_stats));
+            continue;
+        }
+
+        ARROW_RETURN_NOT_OK(VisitOrderedType(
+             *col_type
+            ,[&](const auto &arrow_type) {
+                 using ArrowType = std::decay_t<decltype(arrow_type)>;
+                 return ChunkMinMax<ArrowType>(*chunk, col_type, &chunk_stats);
+             }
+        ));
+
+        stats_by_chunk.push_back(std::move(chunk_stats));
+    }
+
+    return Status::OK();
+}
+
+/**
+ * A chunk's `[min, max]` doesn't cover its NaNs. That's fine, because NaN is never found
+ * (it's not equal to itself).
+ */
+bool
+ZoneMap::MayContain(int chunk_ndx, const Scalar &search_val) const {
+    if (not is_ordered) { return true; }
+
+    const ChunkStatistics &chunk_stats = stats_by_chunk[chunk_ndx];
+    if (chunk_stats.min_val == nullptr or not search_val.is_valid) { return false; }
+
+    bool   may_contain  = true;
+    Status visit_status = VisitOrderedType(
+         *indexed_arr->type()
+        ,[&](const auto &arrow_type) {
+             using ArrowType = std::decay_t<decltype(arrow_type)>;
+
+             auto search_key = ScalarKey<ArrowType>(search_val);
+             may_contain = (
+                     not SortsBefore(search_key, ScalarKey<ArrowType>(*chunk_stats.min_val))
+                 and not SortsBefore(ScalarKey<ArrowType>(*chunk_stats.max_val), search_key)
+             );
+
+             return Status::OK();
+         }
+    );
+
+    // If the type can't be compared, the chunk can't be ruled out
+    return not visit_status.ok() or may_contain;
+}
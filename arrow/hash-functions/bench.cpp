@@ -0,0 +1,481 @@
+// ------------------------------
+// Dependencies
+
+// Local and third-party dependencies
+#include "recipe.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <arrow/util/byte_size.h>
+
+// ------------------------------
+// Macros and aliases
+
+using std::chrono::steady_clock;
+
+/**
+ * Key columns are built from this list, in order, repeating it for more than 6 columns; so
+ * wider keys mix fixed widths of 1 to 8 bytes with variable-width strings.
+ */
+const vector<string> KEY_COLTYPES { "int64", "int32", "utf8", "int16", "int8", "double" };
+
+
+// ------------------------------
+// Structs and Classes
+
+/**
+ * The number of rows in each key batch, and how long `HashBatch` is timed for each key
+ * shape and hash width: at least `min_calls` calls, over at least `min_seconds`.
+ */
+struct SweepConfig {
+    int64_t row_count   { 1 << 20 };
+    double  min_seconds { 0.2 };
+    int     min_calls   { 3 };
+};
+
+/**
+ * The shape of a key: how many columns (typed from `KEY_COLTYPES`), how long its strings
+ * can be, and how often a value (other than in the first column) is null.
+ */
+struct KeyShape {
+    int    col_count;
+    int    max_str_len;
+    double null_fraction;
+
+    string
+    ColTypes() const {
+        string col_types;
+        for (int col_ndx = 0; col_ndx < col_count; ++col_ndx) {
+            if (col_ndx > 0) { col_types += ","; }
+            col_types += KEY_COLTYPES[col_ndx % KEY_COLTYPES.size()];
+        }
+
+        return col_types;
+    }
+
+    string
+    ToJson() const {
+        std::ostringstream json_stream;
+        json_stream <<   "\"columns\": "       << col_count
+                    << ", \"types\": \""       << ColTypes() << "\""
+                    << ", \"max_str_len\": "   << max_str_len
+                    << ", \"null_fraction\": " << null_fraction
+        ;
+
+        return json_stream.str();
+    }
+};
+
+/**
+ * Throughput of `HashBatch` for one key shape and hash width, and how many of the (distinct)
+ * keys got a hash that another key already had. `expected_collisions` is the number a
+ * uniformly random hash of the same width would give: n * (n - 1) / 2^(bits + 1).
+ */
+struct ThroughputResult {
+    KeyShape key_shape;
+    int      hash_bits;
+    int64_t  row_count;
+    int64_t  input_bytes;
+    int      calls;
+    double   best_ns;
+    double   mean_ns;
+    int64_t  collisions;
+    double   expected_collisions;
+
+    string
+    ToJson() const {
+        double best_seconds = best_ns / 1e9;
+
+        std::ostringstream json_stream;
+        json_stream << "{"
+                    <<   "\"measure\": \"throughput\""
+                    << ", \"hash_bits\": "           << hash_bits
+                    << ", "                          << key_shape.ToJson()
+                    << ", \"rows\": "                << row_count
+                    << ", \"calls\": "               << calls
+                    << ", \"ns_per_row\": "          << best_ns / row_count
+                    << ", \"mean_ns_per_row\": "     << mean_ns / row_count
+                    << ", \"rows_per_s\": "          << row_count / best_seconds
+                    << ", \"bytes_per_s\": "         << input_bytes / best_seconds
+                    << ", \"collisions\": "          << collisions
+                    << ", \"expected_collisions\": " << expected_collisions
+                    << "}"
+        ;
+
+        return json_stream.str();
+    }
+};
+
+/**
+ * How evenly the hashes fill a table of 2^`table_bits` buckets, when a bucket is chosen by
+ * the hash's low bits (a mask, as hash tables do) or its high bits (multiply-shift, as
+ * "hash_partition" does). For uniform hashes, `chi_square` is close to the degrees of
+ * freedom (buckets - 1), so `chi_square_per_df` is close to 1.
+ */
+struct BucketResult {
+    KeyShape key_shape;
+    int      hash_bits;
+    int64_t  row_count;
+    int      table_bits;
+    string   bucket_bits;
+    double   chi_square;
+
+    string
+    ToJson() const {
+        double degrees_freedom = static_cast<double>((int64_t { 1 } << table_bits) - 1);
+
+        std::ostringstream json_stream;
+        json_stream << "{"
+                    <<   "\"measure\": \"buckets\""
+                    << ", \"hash_bits\": "         << hash_bits
+                    << ", "                        << key_shape.ToJson()
+                    << ", \"rows\": "              << row_count
+                    << ", \"table_bits\": "        << table_bits
+                    << ", \"bucket_bits\": \""     << bucket_bits << "\""
+                    << ", \"chi_square\": "        << chi_square
+                    << ", \"chi_square_per_df\": " << chi_square / degrees_freedom
+                    << "}"
+        ;
+
+        return json_stream.str();
+    }
+};
+
+
+// ------------------------------
+// Functions
+
+// >> Input data
+
+/**
+ * Builds `row_count` distinct int64 values, so that every key (which includes this column)
+ * is distinct, and any two rows with the same hash are a collision. Multiplying by an odd
+ * constant is a bijection on 64 bits, and scatters the row indices.
+ */
+Result<shared_ptr<Array>>
+BuildDistinctColumn(int64_t row_count) {
+    arrow::Int64Builder col_builder;
+    ARROW_RETURN_NOT_OK(col_builder.Reserve(row_count));
+
+    for (int64_t row_ndx = 0; row_ndx < row_count; ++row_ndx) {
+        col_builder.UnsafeAppend(
+            static_cast<int64_t>(static_cast<uint64_t>(row_ndx) * 0x9E3779B97F4A7C15ULL)
+        );
+    }
+
+    return col_builder.Finish();
+}
+
+/**
+ * The distribution of random `CType` values: integers span the whole type (drawn as int64,
+ * since `uniform_int_distribution` doesn't take 8-bit types), and floats are centered on 0.
+ */
+template <typename CType>
+auto
+ValueDistribution() {
+    if constexpr (std::is_floating_point<CType>::value) {
+        return std::uniform_real_distribution<double> { -1e6, 1e6 };
+    }
+
+    else {
+        return std::uniform_int_distribution<int64_t> {
+             static_cast<int64_t>(std::numeric_limits<CType>::lowest())
+            ,static_cast<int64_t>(std::numeric_limits<CType>::max())
+        };
+    }
+}
+
+/** Builds `row_count` random values of `ArrowType`, each null with `null_fraction`. */
+template <typename ArrowType>
+Result<shared_ptr<Array>>
+BuildRandomColumn(int64_t row_count, double null_fraction, uint64_t seed) {
+    using CType = typename ArrowType::c_type;
+
+    std::mt19937_64             rng       { seed };
+    auto                        val_dist  = ValueDistribution<CType>();
+    std::bernoulli_distribution null_dist { null_fraction };
+
+    arrow::NumericBuilder<ArrowType> col_builder;
+    ARROW_RETURN_NOT_OK(col_builder.Reserve(row_count));
+
+    for (int64_t row_ndx = 0; row_ndx < row_count; ++row_ndx) {
+        if (null_fraction > 0 and null_dist(rng)) {
+            col_builder.UnsafeAppendNull();
+            continue;
+        }
+
+        col_builder.UnsafeAppend(static_cast<CType>(val_dist(rng)));
+    }
+
+    return col_builder.Finish();
+}
+
+/**
+ * Builds `row_count` random strings of `max_str_len / 2` to `max_str_len` characters, each
+ * null with `null_fraction`.
+ */
+Result<shared_ptr<Array>>
+BuildRandomStrings(int64_t row_count, int max_str_len, double null_fraction, uint64_t seed) {
+    std::mt19937_64                 rng       { seed };
+    std::uniform_int_distribution<> len_dist  { std::max(max_str_len / 2, 1), max_str_len };
+    std::uniform_int_distribution<> char_dist { 'a', 'z' };
+    std::bernoulli_distribution     null_dist { null_fraction };
+
+    arrow::StringBuilder col_builder;
+    ARROW_RETURN_NOT_OK(col_builder.Reserve(row_count));
+    ARROW_RETURN_NOT_OK(col_builder.ReserveData(row_count * max_str_len));
+
+    string str_val;
+    for (int64_t row_ndx = 0; row_ndx < row_count; ++row_ndx) {
+        if (null_fraction > 0 and null_dist(rng)) {
+            col_builder.UnsafeAppendNull();
+            continue;
+        }
+
+        str_val.resize(len_dist(rng));
+        for (auto &str_char : str_val) { str_char = static_cast<char>(char_dist(rng)); }
+
+        col_builder.UnsafeAppend(str_val);
+    }
+
+    return col_builder.Finish();
+}
+
+Result<shared_ptr<Array>>
+BuildKeyColumn(const KeyShape &key_shape, int64_t row_count, int col_ndx) {
+    if (col_ndx == 0) { return BuildDistinctColumn(row_count); }
+
+    const auto &type_name     = KEY_COLTYPES[col_ndx % KEY_COLTYPES.size()];
+    double      null_fraction = key_shape.null_fraction;
+    uint64_t    col_seed      = 42 + col_ndx;
+
+    if (type_name == "int64" ) { return BuildRandomColumn<arrow::Int64Type> (row_count, null_fraction, col_seed); }
+    if (type_name == "int32" ) { return BuildRandomColumn<arrow::Int32Type> (row_count, null_fraction, col_seed); }
+    if (type_name == "int16" ) { return BuildRandomColumn<arrow::Int16Type> (row_count, null_fraction, col_seed); }
+    if (type_name == "int8"  ) { return BuildRandomColumn<arrow::Int8Type>  (row_count, null_fraction, col_seed); }
+    if (type_name == "double") { return BuildRandomColumn<arrow::DoubleType>(row_count, null_fraction, col_seed); }
+    if (type_name == "utf8"  ) {
+        return BuildRandomStrings(row_count, key_shape.max_str_len, null_fraction, col_seed);
+    }
+
+    return Status::Invalid("No key column generator for type: ", type_name);
+}
+
+Result<shared_ptr<RecordBatch>>
+BuildKeyBatch(const KeyShape &key_shape, int64_t row_count) {
+    vector<shared_ptr<Field>> key_fields;
+    ArrayVector               key_cols;
+
+    for (int col_ndx = 0; col_ndx < key_shape.col_count; ++col_ndx) {
+        ARROW_ASSIGN_OR_RAISE(auto key_col, BuildKeyColumn(key_shape, row_count, col_ndx));
+
+        key_fields.push_back(arrow::field("key" + std::to_string(col_ndx), key_col->type()));
+        key_cols.push_back(std::move(key_col));
+    }
+
+    return RecordBatch::Make(arrow::schema(key_fields), row_count, key_cols);
+}
+
+
+// >> Hash quality
+
+/** The number of hashes equal to an earlier one (sorts a copy of `row_hashes`). */
+template <typename HashType>
+int64_t
+CountCollisions(vector<HashType> row_hashes) {
+    std::sort(row_hashes.begin(), row_hashes.end());
+
+    auto distinct_end = std::unique(row_hashes.begin(), row_hashes.end());
+    return static_cast<int64_t>(row_hashes.end() - distinct_end);
+}
+
+/**
+ * Pearson's chi-square of the bucket counts, for a table of 2^`table_bits` buckets, where
+ * a row's bucket is taken from the low or the high `table_bits` bits of its hash.
+ */
+template <typename HashType>
+double
+BucketChiSquare(const vector<HashType> &row_hashes, int table_bits, bool use_high_bits) {
+    constexpr int hash_bits    = 8 * sizeof(HashType);
+    int64_t       bucket_count = int64_t { 1 } << table_bits;
+    HashType      bucket_mask  = static_cast<HashType>(bucket_count - 1);
+
+    vector<int64_t> bucket_rows(bucket_count, 0);
+    for (HashType row_hash : row_hashes) {
+        if (use_high_bits) { ++bucket_rows[row_hash >> (hash_bits - table_bits)]; }
+        else               { ++bucket_rows[row_hash & bucket_mask];               }
+    }
+
+    double expected_rows = static_cast<double>(row_hashes.size()) / bucket_count;
+    double chi_square    = 0;
+    for (int64_t bucket_size : bucket_rows) {
+        double bucket_diff  = bucket_size - expected_rows;
+        chi_square         += bucket_diff * bucket_diff / expected_rows;
+    }
+
+    return chi_square;
+}
+
+
+// >> Measurement
+
+/**
+ * Times `HashBatch` over all of `key_batch`. The first call isn't timed, since it's the one
+ * that first touches the stack and `row_hashes`. Every call writes the same hashes, which
+ * are then used for the collision count and the bucket chi-square.
+ *
+ * A call that runs undisturbed is the fastest, so the best call gives the throughput; the
+ * mean is reported next to it, to show how noisy the machine was.
+ */
+template <typename HashingType, typename HashType>
+Result<ThroughputResult>
+MeasureHashBatch( const SweepConfig      &config
+                 ,const KeyShape         &key_shape
+                 ,const RecordBatch      &key_batch
+                 ,vector<HashType>       *row_hashes) {
+    auto    exec_ctx  = default_exec_context();
+    int64_t row_count = key_batch.num_rows();
+
+    ExecBatch       input_batch { key_batch };
+    TempVectorStack hash_stack;
+    ARROW_RETURN_NOT_OK(
+        hash_stack.Init(exec_ctx->memory_pool(), HashStackSize(8 * sizeof(HashType)))
+    );
+
+    row_hashes->resize(row_count);
+    auto HashKeys = [&]() {
+        return HashingType::HashBatch(
+             input_batch
+            ,row_hashes->data()
+            ,exec_ctx->cpu_info()->hardware_flags()
+            ,&hash_stack
+            ,0
+            ,row_count
+        );
+    };
+
+    ARROW_RETURN_NOT_OK(HashKeys());
+
+    vector<double> call_ns;
+    double         total_ns = 0;
+    while (    static_cast<int>(call_ns.size()) < config.min_calls
+           or  total_ns < config.min_seconds * 1e9) {
+        auto tstart = steady_clock::now();
+        ARROW_RETURN_NOT_OK(HashKeys());
+
+        std::chrono::duration<double, std::nano> elapsed = steady_clock::now() - tstart;
+        call_ns.push_back(elapsed.count());
+        total_ns += elapsed.count();
+    }
+
+    double hash_space = std::ldexp(1.0, 8 * sizeof(HashType));
+    return ThroughputResult {
+         key_shape
+        ,static_cast<int>(8 * sizeof(HashType))
+        ,row_count
+        ,arrow::util::TotalBufferSize(key_batch)
+        ,static_cast<int>(call_ns.size())
+        ,*std::min_element(call_ns.begin(), call_ns.end())
+        ,total_ns / call_ns.size()
+        ,CountCollisions(*row_hashes)
+        ,static_cast<double>(row_count) * (row_count - 1) / (2 * hash_space)
+    };
+}
+
+/**
+ * Measures one hash width on `key_batch`: its throughput and collisions, then the bucket
+ * chi-square for tables of 2^8, 2^12 and 2^16 buckets (skipping tables too large for
+ * the test, where buckets would expect fewer than 5 rows).
+ */
+template <typename HashingType, typename HashType>
+Status
+RunHashWidth( const SweepConfig  &config
+             ,const KeyShape     &key_shape
+             ,const RecordBatch  &key_batch) {
+    vector<HashType> row_hashes;
+    ARROW_ASSIGN_OR_RAISE(
+         auto throughput_result
+        ,(MeasureHashBatch<HashingType, HashType>(config, key_shape, key_batch, &row_hashes))
+    );
+
+    std::cout << throughput_result.ToJson() << std::endl;
+
+    for (int table_bits : { 8, 12, 16 }) {
+        if (key_batch.num_rows() < (int64_t { 5 } << table_bits)) { continue; }
+
+        for (bool use_high_bits : { false, true }) {
+            BucketResult bucket_result {
+                 key_shape
+                ,throughput_result.hash_bits
+                ,key_batch.num_rows()
+                ,table_bits
+                ,use_high_bits ? "high" : "low"
+                ,BucketChiSquare(row_hashes, table_bits, use_high_bits)
+            };
+
+            std::cout << bucket_result.ToJson() << std::endl;
+        }
+    }
+
+    return Status::OK();
+}
+
+/**
+ * Sweeps key shapes (1 to 16 columns, string lengths and null fractions), measuring both
+ * `Hashing32` and `Hashing64` on the same keys. Shapes that can't differ are skipped: a
+ * single column is always the distinct (non-null) int64 column, and keys of fewer than 3
+ * columns have no strings.
+ */
+Status
+RunSweep(const SweepConfig &config) {
+    vector<int>    col_counts     { 1, 2, 4, 8, 16 };
+    vector<int>    max_str_lens   { 8, 64 };
+    vector<double> null_fractions { 0.0, 0.1, 0.5 };
+
+    for (int col_count : col_counts) {
+        for (int max_str_len : max_str_lens) {
+            if (col_count < 3 and max_str_len != max_str_lens.front()) { continue; }
+
+            for (double null_fraction : null_fractions) {
+                if (col_count == 1 and null_fraction > 0) { continue; }
+
+                KeyShape key_shape { col_count, max_str_len, null_fraction };
+                ARROW_ASSIGN_OR_RAISE(auto key_batch, BuildKeyBatch(key_shape, config.row_count));
+
+                ARROW_RETURN_NOT_OK(
+                    (RunHashWidth<Hashing32, uint32_t>(config, key_shape, *key_batch))
+                );
+
+                ARROW_RETURN_NOT_OK(
+                    (RunHashWidth<Hashing64, uint64_t>(config, key_shape, *key_batch))
+                );
+            }
+        }
+    }
+
+    return Status::OK();
+}
+
+
+/**
+ * Usage: hash-bench [row_count] [min_seconds]
+ *
+ * For each key shape and hash width, prints a "throughput" line and then its "buckets"
+ * lines, each a JSON object (the README describes their fields).
+ */
+int main(int argc, char **argv) {
+    SweepConfig config;
+    if (argc > 1) { config.row_count   = std::stoll(argv[1]); }
+    if (argc > 2) { config.min_seconds = std::stod (argv[2]); }
+
+    auto sweep_status = RunSweep(config);
+    if (not sweep_status.ok()) {
+        std::cerr << sweep_status.message() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -50,6 +50,36 @@ ConstructTestBatch(int64_t row_count, int col_count) {
     return RecordBatch::Make(batch_schema, row_count, batch_data);
 }
 
+/**
+ * Hashes the key columns of a table, read as a stream of small batches, with 64-bit hashes.
+ * A stream from a file (e.g. an IPC reader) is hashed the same way.
+ */
+Status
+StreamHashes( shared_ptr<RecordBatch>  input_batch
+             ,vector<int>             &col_indices) {
+    ARROW_ASSIGN_OR_RAISE(auto input_table, Table::FromRecordBatches({ input_batch }));
+
+    auto table_reader = std::make_shared<arrow::TableBatchReader>(*input_table);
+    table_reader->set_chunksize(2);
+
+    ARROW_ASSIGN_OR_RAISE(
+         auto batch_hasher
+        ,BatchHasher::Make(table_reader, col_indices, /*hash_bits=*/64)
+    );
+
+    // `table_reader` references `input_table`, which must outlive the stream
+    for (;;) {
+        ARROW_ASSIGN_OR_RAISE(auto hashed_batch, batch_hasher->Next());
+        if (hashed_batch.batch == nullptr) { break; }
+
+        std::cout << "Stream Hashes (" << hashed_batch.batch->num_rows() << " rows): "
+                  << hashed_batch.hashes->ToString()                      << std::endl
+        ;
+    }
+
+    return Status::OK();
+}
+
 /**
  * A simple main function that just constructs a single table containing a single column that is
  * backed by a `arrow::DictionaryArray`.
@@ -59,27 +89,91 @@ int main(int argc, char **argv) {
     shared_ptr<RecordBatch> input_batch = ConstructTestBatch(5, 5);
 
     vector<int> col_indices = { 1, 3 };
-    auto        col_bufsize = CalculateTempStackSize<StringType, StringArray>(
-        std::static_pointer_cast<StringArray>(input_batch->column(0))
-    );
+
+    // The scratch space HashBatch needs is the same for any keys, so it's known up front
+    std::cout << "Hash stack size (bytes): " << HashStackSize() << std::endl;
 
     // Call a convenience wrapper around `arrow::compute::exec::Hashing32::HashBatch`
-    auto hash_status = HashBatchColumns(
+    auto hash_result = HashBatchColumns(input_batch, col_indices);
+
+    if (not hash_result.ok()) {
+        std::cerr << "Error when hashing the data:"          << std::endl
+                  << "\t" << hash_result.status().message() << std::endl
+        ;
+
+        return 1;
+    }
+
+    // View the result
+    std::cout << "Result Hashes: " << (*hash_result)->ToString() << std::endl;
+
+    // Hash the same keys on the thread pool, 2 rows per range; the hashes are the same
+    auto parallel_result = HashBatchColumnsParallel(
          input_batch
         ,col_indices
-        ,col_bufsize * col_indices.size()
+        ,/*hash_bits=*/32
+        ,default_exec_context()
+        ,/*range_rows=*/2
     );
 
-    if (not hash_status.ok()) {
-        std::cerr << "Error when hashing the data:" << std::endl
-                  << "\t" << hash_status.message()  << std::endl
+    if (not parallel_result.ok()) {
+        std::cerr << "Error when hashing in parallel:"          << std::endl
+                  << "\t" << parallel_result.status().message() << std::endl
         ;
 
         return 1;
     }
 
-    // View the result
-    std::cout << "Hash status: " << hash_status.ToString() << std::endl;
+    std::cout << "Parallel hashes equal: " << (*parallel_result)->Equals(*hash_result) << std::endl;
+
+    // Hash a stream of batches (here, a table read in batches of 2 rows) with one hasher
+    auto stream_status = StreamHashes(input_batch, col_indices);
+    if (not stream_status.ok()) {
+        std::cerr << "Error when hashing the stream:" << std::endl
+                  << "\t" << stream_status.message() << std::endl
+        ;
+
+        return 1;
+    }
+
+    // Partition the rows by the same key columns, in a single call
+    auto partition_result = HashPartitionBatch(input_batch, col_indices, 2);
+    if (not partition_result.ok()) {
+        std::cerr << "Error when partitioning the data:"            << std::endl
+                  << "\t" << partition_result.status().message() << std::endl
+        ;
+
+        return 2;
+    }
+
+    std::cout << "Partition ids: " << partition_result->partition_ids->ToString() << std::endl
+              << "Permutation: "   << partition_result->permutation->ToString()   << std::endl
+              << "Partition counts:"                                               << std::endl
+    ;
+
+    for (auto partition_count : partition_result->partition_counts) {
+        std::cout << "\t" << partition_count << std::endl;
+    }
+
+    // The same partitioning, as the "hash_partition" compute function
+    RegisterHashPartitionFn(GetFunctionRegistry());
+
+    HashPartitionOptions partition_opts { 2 };
+    auto partition_fn_result = CallFunction(
+         "hash_partition"
+        ,{ input_batch->column(col_indices[0]), input_batch->column(col_indices[1]) }
+        ,&partition_opts
+    );
+
+    if (not partition_fn_result.ok()) {
+        std::cerr << "Error when calling hash_partition:"           << std::endl
+                  << "\t" << partition_fn_result.status().message() << std::endl
+        ;
+
+        return 3;
+    }
+
+    std::cout << "hash_partition: " << partition_fn_result->make_array()->ToString() << std::endl;
 
     return 0;
 }
@@ -0,0 +1,305 @@
+// ------------------------------
+// Dependencies
+
+// Local and third-party dependencies
+#include "recipe.hpp"
+
+// ------------------------------
+// Macros and aliases
+
+
+// ------------------------------
+// Options
+
+/**
+ * Arrow generates `FunctionOptionsType`s for its own options with internal helpers, which
+ * aren't installed; so this one is written out.
+ */
+class HashPartitionOptionsType : public FunctionOptionsType {
+    public:
+        const char*
+        type_name() const override { return HashPartitionOptions::kTypeName; }
+
+        string
+        Stringify(const FunctionOptions &options) const override {
+            auto num_partitions = static_cast<const HashPartitionOptions&>(options).num_partitions;
+            return "HashPartitionOptions(num_partitions=" + std::to_string(num_partitions) + ")";
+        }
+
+        bool
+        Compare(const FunctionOptions &lhs, const FunctionOptions &rhs) const override {
+            return (
+                   static_cast<const HashPartitionOptions&>(lhs).num_partitions
+                == static_cast<const HashPartitionOptions&>(rhs).num_partitions
+            );
+        }
+
+        std::unique_ptr<FunctionOptions>
+        Copy(const FunctionOptions &options) const override {
+            return std::make_unique<HashPartitionOptions>(
+                static_cast<const HashPartitionOptions&>(options)
+            );
+        }
+};
+
+const FunctionOptionsType*
+GetHashPartitionOptionsType() {
+    static const HashPartitionOptionsType options_type;
+    return &options_type;
+}
+
+HashPartitionOptions::HashPartitionOptions(int32_t num_partitions)
+    : FunctionOptions(GetHashPartitionOptionsType())
+     ,num_partitions(num_partitions) {}
+
+
+// ------------------------------
+// Functions
+
+// >> Partitioning
+
+/**
+ * Assigns each row of `key_batch` to one of `num_partitions` partitions, by the hash of
+ * all of its key columns, and groups the rows by partition with a counting sort:
+ *
+ *  1. Hash every row into the partition id buffer with `Hashing32::HashBatch`, then map
+ *     each hash to a partition in place. The mapping is multiply-shift (the high 32 bits
+ *     of `hash * num_partitions`), which avoids a division and uses the hash's high bits.
+ *  2. Count the rows in each partition; the exclusive prefix sum of the counts gives each
+ *     partition's first position in the permutation.
+ *  3. Scatter each row index to the next position for its partition. Rows are visited in
+ *     order, so rows stay in their original order within each partition (a stable sort).
+ *
+ * This replaces hashing, then `sort_indices`, then a `take` per partition: `take` with
+ * the whole permutation gathers rows grouped by partition, and the counts give each
+ * partition's slice of the result.
+ */
+Result<HashPartitions>
+HashPartitionRows(const ExecBatch &key_batch, int32_t num_partitions, ExecContext *exec_ctx) {
+    if (num_partitions <= 0) {
+        return Status::Invalid("num_partitions must be positive, got ", num_partitions);
+    }
+
+    int64_t row_count = key_batch.length;
+
+    HashPartitions partitions;
+    partitions.partition_counts.assign(num_partitions, 0);
+
+    ARROW_ASSIGN_OR_RAISE(
+         auto partition_ids
+        ,arrow::AllocateBuffer(row_count * sizeof(uint32_t), exec_ctx->memory_pool())
+    );
+    ARROW_ASSIGN_OR_RAISE(
+         auto permutation
+        ,arrow::AllocateBuffer(row_count * sizeof(int64_t), exec_ctx->memory_pool())
+    );
+
+    // >> 1. Hash each row, then map its hash to a partition
+    auto row_pids = reinterpret_cast<uint32_t*>(partition_ids->mutable_data());
+
+    TempVectorStack hash_stack;
+    ARROW_RETURN_NOT_OK(hash_stack.Init(exec_ctx->memory_pool(), HashStackSize()));
+    ARROW_RETURN_NOT_OK(
+        Hashing32::HashBatch(
+             key_batch
+            ,row_pids
+            ,exec_ctx->cpu_info()->hardware_flags()
+            ,&hash_stack
+            ,0
+            ,row_count
+        )
+    );
+
+    // >> 2. Count rows per partition (in the same pass as the mapping)
+    for (int64_t row_ndx = 0; row_ndx < row_count; ++row_ndx) {
+        uint32_t row_pid = static_cast<uint32_t>(
+            (static_cast<uint64_t>(row_pids[row_ndx]) * num_partitions) >> 32
+        );
+
+        row_pids[row_ndx] = row_pid;
+        ++partitions.partition_counts[row_pid];
+    }
+
+    vector<int64_t> next_position(num_partitions, 0);
+    for (int32_t pid = 1; pid < num_partitions; ++pid) {
+        next_position[pid] = next_position[pid - 1] + partitions.partition_counts[pid - 1];
+    }
+
+    // >> 3. Scatter row indices into a permutation grouped by partition
+    auto row_order = reinterpret_cast<int64_t*>(permutation->mutable_data());
+    for (int64_t row_ndx = 0; row_ndx < row_count; ++row_ndx) {
+        row_order[next_position[row_pids[row_ndx]]++] = row_ndx;
+    }
+
+    partitions.partition_ids = std::make_shared<UInt32Array>(row_count, std::move(partition_ids));
+    partitions.permutation   = std::make_shared<Int64Array>(row_count, std::move(permutation));
+
+    return partitions;
+}
+
+Result<HashPartitions>
+HashPartitionBatch( shared_ptr<RecordBatch>  source_batch
+                   ,vector<int>             &key_indices
+                   ,int32_t                  num_partitions) {
+    if (key_indices.empty()) {
+        return Status::Invalid("hash partitioning needs at least one key column");
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto key_batch, source_batch->SelectColumns(key_indices));
+
+    return HashPartitionRows(ExecBatch(*key_batch), num_partitions, default_exec_context());
+}
+
+
+// >> Registration as a compute function
+
+const FunctionDoc hash_partition_doc {
+     "Assign rows to partitions by the hash of their key columns"
+    ,(
+         "Every argument is a key column. Returns a struct array with one row per input\n"
+         "row: 'partition_id' is the row's partition, and 'permutation' is a stable\n"
+         "ordering of row indices that groups rows by partition (for use with 'take').\n"
+         "'partition_counts' holds the number of rows in each partition, in its first\n"
+         "row (later rows are empty lists); partition p's rows are the next\n"
+         "partition_counts[p] entries of 'permutation'.\n"
+         "Use HashPartitionOptions to set the number of partitions."
+     )
+    ,{ "*keys" }
+    ,"HashPartitionOptions"
+};
+
+struct HashPartitionState : public KernelState {
+    explicit HashPartitionState(int32_t num_partitions) : num_partitions(num_partitions) {}
+
+    int32_t num_partitions;
+};
+
+Result<std::unique_ptr<KernelState>>
+InitHashPartition(KernelContext*, const KernelInitArgs &args) {
+    if (args.options == nullptr) {
+        return Status::Invalid("Attempted to call hash_partition without options");
+    }
+
+    auto options = static_cast<const HashPartitionOptions*>(args.options);
+    return std::make_unique<HashPartitionState>(options->num_partitions);
+}
+
+/**
+ * The partition counts aren't row-aligned (there's one per partition), but the output of
+ * a function is a single array; so they're a list column whose first row is the counts,
+ * and whose later rows are empty. That costs an offsets buffer, rather than recounting
+ * the partition ids.
+ */
+Result<shared_ptr<arrow::ArrayData>>
+MakeCountsColumn( const shared_ptr<arrow::DataType> &counts_type
+                 ,const vector<int64_t>             &partition_counts
+                 ,int64_t                            row_count
+                 ,arrow::MemoryPool                 *pool) {
+    int64_t counts_len = (row_count > 0) ? static_cast<int64_t>(partition_counts.size()) : 0;
+
+    ARROW_ASSIGN_OR_RAISE(auto count_vals, arrow::AllocateBuffer(counts_len * sizeof(int64_t), pool));
+    std::copy_n(
+         partition_counts.data()
+        ,counts_len
+        ,reinterpret_cast<int64_t*>(count_vals->mutable_data())
+    );
+
+    ARROW_ASSIGN_OR_RAISE(
+         auto list_offsets
+        ,arrow::AllocateBuffer((row_count + 1) * sizeof(int32_t), pool)
+    );
+
+    auto row_offsets = reinterpret_cast<int32_t*>(list_offsets->mutable_data());
+    row_offsets[0]   = 0;
+    std::fill_n(row_offsets + 1, row_count, static_cast<int32_t>(counts_len));
+
+    auto counts_data = arrow::ArrayData::Make(
+         arrow::int64()
+        ,counts_len
+        ,{ nullptr, std::move(count_vals) }
+        ,/*null_count=*/0
+    );
+
+    return arrow::ArrayData::Make(
+         counts_type
+        ,row_count
+        ,{ nullptr, std::move(list_offsets) }
+        ,{ std::move(counts_data) }
+        ,/*null_count=*/0
+    );
+}
+
+/**
+ * The permutation covers the whole input, so this kernel can't be run one chunk at a time
+ * (`can_execute_chunkwise` is false) and it only accepts arrays.
+ */
+Status
+ExecHashPartition(KernelContext *ctx, const ExecSpan &input_args, ExecResult *out) {
+    for (const auto &key_arg : input_args.values) {
+        if (not key_arg.is_array()) {
+            return Status::Invalid("hash_partition expects every argument to be an array");
+        }
+    }
+
+    auto num_partitions = static_cast<HashPartitionState*>(ctx->state())->num_partitions;
+
+    ARROW_ASSIGN_OR_RAISE(
+         auto partitions
+        ,HashPartitionRows(input_args.ToExecBatch(), num_partitions, ctx->exec_context())
+    );
+
+    auto out_type = ctx->kernel()->signature->out_type().type();
+    ARROW_ASSIGN_OR_RAISE(
+         auto counts_data
+        ,MakeCountsColumn(
+              out_type->field(2)->type()
+             ,partitions.partition_counts
+             ,input_args.length
+             ,ctx->exec_context()->memory_pool()
+         )
+    );
+
+    out->value    = arrow::ArrayData::Make(
+         out_type->GetSharedPtr()
+        ,input_args.length
+        ,{ nullptr }
+        ,{ partitions.partition_ids->data(), partitions.permutation->data(), counts_data }
+        ,/*null_count=*/0
+    );
+
+    return Status::OK();
+}
+
+void
+RegisterHashPartitionFn(FunctionRegistry *registry) {
+    static const HashPartitionOptions default_options;
+
+    auto fn_hash_partition = std::make_shared<VectorFunction>(
+         "hash_partition"
+        ,Arity::VarArgs(1)
+        ,hash_partition_doc
+        ,&default_options
+    );
+
+    auto out_type = arrow::struct_({
+         arrow::field("partition_id", arrow::uint32(), /*nullable=*/false)
+        ,arrow::field("permutation" , arrow::int64() , /*nullable=*/false)
+        ,arrow::field(
+              "partition_counts"
+             ,arrow::list(arrow::field("item", arrow::int64(), /*nullable=*/false))
+             ,/*nullable=*/false
+         )
+    });
+
+    VectorKernel kernel {
+         KernelSignature::Make({ InputType::Any() }, OutputType(out_type), /*is_varargs=*/true)
+        ,ExecHashPartition
+        ,InitHashPartition
+    };
+
+    kernel.null_handling         = NullHandling::OUTPUT_NOT_NULL;
+    kernel.can_execute_chunkwise = false;
+    ARROW_CHECK_OK(fn_hash_partition->AddKernel(std::move(kernel)));
+
+    ARROW_CHECK_OK(registry->AddFunction(std::move(fn_hash_partition)));
+}
@@ -4,6 +4,10 @@
 // Local and third-party dependencies
 #include "recipe.hpp"
 
+#include <atomic>
+#include <arrow/util/parallel.h>
+#include <arrow/util/thread_pool.h>
+
 // ------------------------------
 // Macros and aliases
 
@@ -15,50 +19,240 @@ constexpr uint32_t UNIT_SIZE     = 128;
 // ------------------------------
 // Functions
 
+/**
+ * Hashes every row of `key_batch` into a new buffer of `HashType` (`uint32_t` for
+ * `Hashing32`, `uint64_t` for `Hashing64`), allocating scratch vectors from `hash_stack`.
+ * The stack is grown to what this call needs first, so `HashBatch` never allocates past
+ * its end (which `TempVectorStack` only checks in debug builds).
+ */
+template <typename HashingType, typename HashType>
+Result<shared_ptr<arrow::Buffer>>
+HashRows( const ExecBatch    &key_batch
+         ,ExecContext        *exec_ctx
+         ,GrowableTempStack  *hash_stack) {
+    ARROW_ASSIGN_OR_RAISE(
+         auto hash_buffer
+        ,arrow::AllocateBuffer(key_batch.length * sizeof(HashType), exec_ctx->memory_pool())
+    );
+
+    ARROW_RETURN_NOT_OK(hash_stack->Reserve(HashStackSize(8 * sizeof(HashType))));
+    ARROW_RETURN_NOT_OK(
+        HashingType::HashBatch(
+             key_batch
+            ,reinterpret_cast<HashType*>(hash_buffer->mutable_data())
+            ,exec_ctx->cpu_info()->hardware_flags()
+            ,hash_stack->get()
+            ,0
+            ,key_batch.length
+        )
+    );
+
+    return shared_ptr<arrow::Buffer>(std::move(hash_buffer));
+}
 
 /**
- * A recipe for calling `Hashing32::HashBatch`.
+ * Like `HashRows`, but on the CPU thread pool. Each worker has its own `TempVectorStack`
+ * and hashes the next unclaimed range of `range_rows` rows into that range's slice of
+ * the output, until every range is hashed.
+ *
+ * A row's hash depends only on that row's key values, so hashing `[offset, offset +
+ * length)` gives exactly the hashes that hashing the whole batch gives for those rows.
+ * The result is the same as `HashRows`, bit for bit, whichever worker hashes which range.
+ */
+template <typename HashingType, typename HashType>
+Result<shared_ptr<arrow::Buffer>>
+HashRowsParallel( const ExecBatch  &key_batch
+                 ,ExecContext      *exec_ctx
+                 ,int64_t           range_rows) {
+    ARROW_ASSIGN_OR_RAISE(
+         auto hash_buffer
+        ,arrow::AllocateBuffer(key_batch.length * sizeof(HashType), exec_ctx->memory_pool())
+    );
+
+    auto    row_hashes     = reinterpret_cast<HashType*>(hash_buffer->mutable_data());
+    auto    hardware_flags = exec_ctx->cpu_info()->hardware_flags();
+    int64_t range_count    = (key_batch.length + range_rows - 1) / range_rows;
+
+    std::atomic<int64_t> next_range { 0 };
+    auto RunWorker = [&](int) -> Status {
+        GrowableTempStack worker_stack { exec_ctx->memory_pool() };
+
+        for (int64_t range_ndx = next_range++; range_ndx < range_count; range_ndx = next_range++) {
+            int64_t range_start  = range_ndx * range_rows;
+            int64_t range_length = std::min(range_rows, key_batch.length - range_start);
+
+            ARROW_RETURN_NOT_OK(worker_stack.Reserve(HashStackSize(8 * sizeof(HashType))));
+            ARROW_RETURN_NOT_OK(
+                HashingType::HashBatch(
+                     key_batch
+                    ,row_hashes + range_start
+                    ,hardware_flags
+                    ,worker_stack.get()
+                    ,range_start
+                    ,range_length
+                )
+            );
+        }
+
+        return Status::OK();
+    };
+
+    auto thread_pool = exec_ctx->executor();
+    if (thread_pool == nullptr) { thread_pool = arrow::internal::GetCpuThreadPool(); }
+
+    int worker_count = static_cast<int>(std::min<int64_t>(
+         range_count
+        ,exec_ctx->use_threads() ? thread_pool->GetCapacity() : 1
+    ));
+
+    ARROW_RETURN_NOT_OK(
+        arrow::internal::OptionalParallelFor(
+             exec_ctx->use_threads()
+            ,worker_count
+            ,RunWorker
+            ,thread_pool
+        )
+    );
+
+    return shared_ptr<arrow::Buffer>(std::move(hash_buffer));
+}
+
+
+// ------------------------------
+// Classes
+
+Result<std::unique_ptr<BatchHasher>>
+BatchHasher::Make( shared_ptr<RecordBatchReader>  source_reader
+                  ,vector<int>                    col_indices
+                  ,int                            hash_bits
+                  ,ExecContext                   *exec_ctx) {
+    if (hash_bits != 32 and hash_bits != 64) {
+        return Status::Invalid("Hash width must be 32 or 64 bits, got ", hash_bits);
+    }
+
+    int field_count = source_reader->schema()->num_fields();
+    for (int col_ndx : col_indices) {
+        if (col_ndx < 0 or col_ndx >= field_count) {
+            return Status::IndexError("Key column ", col_ndx, " is not in the stream's schema");
+        }
+    }
+
+    std::unique_ptr<BatchHasher> batch_hasher { new BatchHasher };
+    batch_hasher->source_reader = std::move(source_reader);
+    batch_hasher->key_indices   = std::move(col_indices);
+    batch_hasher->hash_width    = hash_bits;
+    batch_hasher->exec_ctx      = exec_ctx;
+
+    batch_hasher->hash_stack    = std::make_unique<GrowableTempStack>(exec_ctx->memory_pool());
+
+    return batch_hasher;
+}
+
+/**
+ * `HashBatch` walks the batch one minibatch (`MiniBatch::kMiniBatchLength` rows) at a
+ * time, and its scratch vectors are released before it returns. So the stack is the same
+ * size for every batch, no matter how long the batch is or what its keys hold.
+ */
+Result<HashedBatch>
+BatchHasher::Next() {
+    HashedBatch hashed_batch;
+    ARROW_RETURN_NOT_OK(source_reader->ReadNext(&hashed_batch.batch));
+    if (hashed_batch.batch == nullptr) { return hashed_batch; }
+
+    ARROW_ASSIGN_OR_RAISE(auto key_cols, hashed_batch.batch->SelectColumns(key_indices));
+    ExecBatch key_batch { *key_cols };
+
+    if (hash_width == 64) {
+        ARROW_ASSIGN_OR_RAISE(
+             auto hash_buffer
+            ,(HashRows<Hashing64, uint64_t>(key_batch, exec_ctx, hash_stack.get()))
+        );
+
+        hashed_batch.hashes = std::make_shared<UInt64Array>(key_batch.length, hash_buffer);
+    }
+
+    else {
+        ARROW_ASSIGN_OR_RAISE(
+             auto hash_buffer
+            ,(HashRows<Hashing32, uint32_t>(key_batch, exec_ctx, hash_stack.get()))
+        );
+
+        hashed_batch.hashes = std::make_shared<UInt32Array>(key_batch.length, hash_buffer);
+    }
+
+    return hashed_batch;
+}
+
+
+// ------------------------------
+// Recipe Functions
+
+/**
+ * A recipe for calling `Hashing32::HashBatch` (or `Hashing64::HashBatch`).
  *
  * This shows how to call HashBatch, which requires access to an `ExecContext` and also a
  * `TempVectorStack`. The TempVectorStack must be initialized before HashBatch can
  * allocate memory through it; additionally, the initialized size must be large enough to
- * accommodate memory allocated from it.
+ * accommodate memory allocated from it (which `HashStackSize` computes).
+ *
+ * A single batch is a stream of one batch, so this is a `BatchHasher` over a reader of
+ * just `source_batch`.
  */
-Status
+Result<shared_ptr<Array>>
 HashBatchColumns( shared_ptr<RecordBatch>  source_batch
                  ,vector<int>             &col_indices
-                 ,int64_t                  expected_size) {
-    ARROW_ASSIGN_OR_RAISE(auto process_batch, source_batch->SelectColumns(col_indices));
-
-    auto             exec_ctx    = default_exec_context();
-    auto             input_batch = ExecBatch(*process_batch);
-    vector<uint32_t> result_hashes(input_batch.length);
-
-    TempVectorStack  tmp_stack;
-    auto init_status = tmp_stack.Init(
-         exec_ctx->memory_pool()
-        ,expected_size * process_batch->num_columns()
+                 ,int                      hash_bits) {
+    ARROW_ASSIGN_OR_RAISE(
+         auto batch_reader
+        ,RecordBatchReader::Make({ source_batch }, source_batch->schema())
     );
-    ARROW_WARN_NOT_OK(init_status, "Initialized TempVectorStack");
-
-    auto hash_status = Hashing32::HashBatch(
-         input_batch
-        ,result_hashes.data()
-        ,exec_ctx->cpu_info()->hardware_flags()
-        ,&tmp_stack
-        ,0
-        ,input_batch.length
+
+    ARROW_ASSIGN_OR_RAISE(
+         auto batch_hasher
+        ,BatchHasher::Make(batch_reader, col_indices, hash_bits)
     );
 
-    std::cout << "Result Hashes:" << std::endl
-              << "\t" << std::to_string(result_hashes[0]) << std::endl
-              << "\t" << std::to_string(result_hashes[1]) << std::endl
-              << "\t" << std::to_string(result_hashes[2]) << std::endl
-              << "\t" << std::to_string(result_hashes[3]) << std::endl
-              << "\t" << std::to_string(result_hashes[4]) << std::endl
-    ;
+    ARROW_ASSIGN_OR_RAISE(auto hashed_batch, batch_hasher->Next());
+    return hashed_batch.hashes;
+}
+
+/**
+ * Like `HashBatchColumns`, but for a single large batch (e.g. 100M rows of join keys):
+ * the batch is split into ranges of `range_rows` rows, which are hashed on every core.
+ * The default range (16 minibatches) keeps a range's keys and hashes in a core's cache.
+ */
+Result<shared_ptr<Array>>
+HashBatchColumnsParallel( shared_ptr<RecordBatch>  source_batch
+                         ,vector<int>             &col_indices
+                         ,int                      hash_bits
+                         ,ExecContext             *exec_ctx
+                         ,int64_t                  range_rows) {
+    if (hash_bits != 32 and hash_bits != 64) {
+        return Status::Invalid("Hash width must be 32 or 64 bits, got ", hash_bits);
+    }
+
+    if (range_rows <= 0) {
+        return Status::Invalid("range_rows must be positive, got ", range_rows);
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto key_cols, source_batch->SelectColumns(col_indices));
+    ExecBatch key_batch { *key_cols };
+
+    if (hash_bits == 64) {
+        ARROW_ASSIGN_OR_RAISE(
+             auto hash_buffer
+            ,(HashRowsParallel<Hashing64, uint64_t>(key_batch, exec_ctx, range_rows))
+        );
+
+        return std::make_shared<UInt64Array>(key_batch.length, hash_buffer);
+    }
+
+    ARROW_ASSIGN_OR_RAISE(
+         auto hash_buffer
+        ,(HashRowsParallel<Hashing32, uint32_t>(key_batch, exec_ctx, range_rows))
+    );
 
-    return hash_status;
+    return std::make_shared<UInt32Array>(key_batch.length, hash_buffer);
 }
 
 
@@ -46,16 +46,40 @@ using arrow::PrimitiveArray;
 using arrow::ArrayVector;
 using arrow::StringArray;
 using arrow::ChunkedArray;
+using arrow::UInt32Array;
+using arrow::UInt64Array;
+using arrow::Int64Array;
 
 // relational types
 using arrow::Schema;
 using arrow::Field;
 using arrow::Table;
 using arrow::RecordBatch;
+using arrow::RecordBatchReader;
 
 // compute types
 using arrow::compute::ExecBatch;
+using arrow::compute::ExecContext;
 using arrow::compute::Hashing32;
+using arrow::compute::Hashing64;
+
+// >> types for defining compute functions
+using arrow::compute::FunctionOptions;
+using arrow::compute::FunctionOptionsType;
+using arrow::compute::FunctionDoc;
+using arrow::compute::FunctionRegistry;
+using arrow::compute::VectorFunction;
+using arrow::compute::VectorKernel;
+using arrow::compute::KernelSignature;
+using arrow::compute::KernelState;
+using arrow::compute::KernelInitArgs;
+using arrow::compute::KernelContext;
+using arrow::compute::InputType;
+using arrow::compute::OutputType;
+using arrow::compute::Arity;
+using arrow::compute::NullHandling;
+using arrow::compute::ExecSpan;
+using arrow::compute::ExecResult;
 
 // arrow functions
 using arrow::MakeScalar;
@@ -63,36 +87,139 @@ using arrow::MakeScalar;
 // >> compute functions
 using arrow::compute::Index;
 using arrow::compute::IndexOptions;
+using arrow::compute::CallFunction;
+using arrow::compute::GetFunctionRegistry;
 using arrow::compute::default_exec_context;
 
 
+// ------------------------------
+// Classes
+
+/**
+ * Options for the "hash_partition" compute function.
+ */
+class HashPartitionOptions : public FunctionOptions {
+    public:
+        explicit HashPartitionOptions(int32_t num_partitions = 1);
+
+        static constexpr char kTypeName[] = "HashPartitionOptions";
+
+        int32_t num_partitions;
+};
+
+/**
+ * The result of hash partitioning a batch:
+ *  - `partition_ids`   : each row's partition, in [0, num_partitions)
+ *  - `partition_counts`: the number of rows in each partition
+ *  - `permutation`     : row indices grouped by partition, in partition order; rows within
+ *                        a partition keep their input order
+ */
+struct HashPartitions {
+    shared_ptr<UInt32Array> partition_ids;
+    vector<int64_t>         partition_counts;
+    shared_ptr<Int64Array>  permutation;
+};
+
+/**
+ * A `TempVectorStack` that can be made larger. A `TempVectorStack` has a fixed size once
+ * it's initialized, and allocating past its end is only caught in debug builds; instead,
+ * `Reserve` reinitializes this stack with a larger buffer when it's too small.
+ *
+ * Reinitializing discards the stack's contents, so `Reserve` must only be called between
+ * uses (e.g. before each `HashBatch` call), never while vectors are allocated from it.
+ */
+class GrowableTempStack {
+    public:
+        explicit GrowableTempStack(arrow::MemoryPool *pool = arrow::default_memory_pool())
+            : stack_pool(pool) {}
+
+        /** Makes sure the stack has room for at least `stack_size` bytes. */
+        Status
+        Reserve(int64_t stack_size);
+
+        TempVectorStack*
+        get() { return &temp_stack; }
+
+        int64_t
+        capacity() const { return stack_capacity; }
+
+    private:
+        arrow::MemoryPool                                    *stack_pool;
+        TempVectorStack                                       temp_stack;
+        int64_t                                               stack_capacity { 0 };
+};
+
+/**
+ * A batch read from a stream, and the hash of each of its rows: a `UInt32Array` or a
+ * `UInt64Array`, depending on the hash width. Both are null at the end of the stream.
+ */
+struct HashedBatch {
+    shared_ptr<RecordBatch> batch;
+    shared_ptr<Array>       hashes;
+};
+
+/**
+ * Hashes the key columns of each batch read from a `RecordBatchReader`, one batch at a
+ * time, so a stream of any size (e.g. a multi-GB IPC file) is hashed in the memory of a
+ * single batch and its hashes.
+ *
+ * `HashBatch` allocates its scratch vectors from a `TempVectorStack`; this one is reused
+ * for every batch, and grown (if needed) to `HashStackSize` before each `HashBatch` call.
+ */
+class BatchHasher {
+    public:
+        static Result<std::unique_ptr<BatchHasher>>
+        Make( shared_ptr<RecordBatchReader>  source_reader
+             ,vector<int>                    col_indices
+             ,int                            hash_bits = 32
+             ,ExecContext                   *exec_ctx  = default_exec_context());
+
+        /** Reads the next batch and hashes its key columns. */
+        Result<HashedBatch>
+        Next();
+
+        int
+        hash_bits() const { return hash_width; }
+
+    private:
+        shared_ptr<RecordBatchReader>                         source_reader;
+        vector<int>                                           key_indices;
+        int                                                   hash_width { 32 };
+        ExecContext                                          *exec_ctx   { nullptr };
+        std::unique_ptr<GrowableTempStack>                    hash_stack;
+};
+
+
 // ------------------------------
 // Functions
 
-// template functions
+// recipe functions
+Result<shared_ptr<Array>>
+HashBatchColumns( shared_ptr<RecordBatch>  source_batch
+                 ,vector<int>             &col_indices
+                 ,int                      hash_bits = 32);
 
-template<typename DataType, typename ArrayType>
-arrow::enable_if_base_binary<DataType, int64_t>
-CalculateTempStackSize(shared_ptr<ArrayType> sample_col) {
-  auto arr_slice = std::static_pointer_cast<ArrayType>(
-    sample_col->Slice(0, MiniBatch::kMiniBatchLength)
-  );
+Result<shared_ptr<Array>>
+HashBatchColumnsParallel( shared_ptr<RecordBatch>  source_batch
+                         ,vector<int>             &col_indices
+                         ,int                      hash_bits  = 32
+                         ,ExecContext             *exec_ctx   = default_exec_context()
+                         ,int64_t                  range_rows = 16 * MiniBatch::kMiniBatchLength);
 
-  return 64 * arr_slice->total_values_length();
-}
+Result<HashPartitions>
+HashPartitionRows(const ExecBatch &key_batch, int32_t num_partitions, ExecContext *exec_ctx);
 
-template<typename DataType, typename ArrayType>
-arrow::enable_if_primitive_ctype<DataType, int64_t>
-CalculateTempStackSize(shared_ptr<ArrayType> sample_col) {
-  return 64 * std::min(sample_col->length(), MiniBatch::kMiniBatchLength);
-}
+Result<HashPartitions>
+HashPartitionBatch( shared_ptr<RecordBatch>  source_batch
+                   ,vector<int>             &key_indices
+                   ,int32_t                  num_partitions);
 
+void
+RegisterHashPartitionFn(FunctionRegistry *registry);
 
-// recipe functions
-Status
-HashBatchColumns( shared_ptr<RecordBatch>  source_batch
-                 ,vector<int>             &col_indices
-                 ,int64_t                  expected_size);
+// >> scratch space
+int64_t
+HashStackSize(int hash_bits = 32);
 
 // convenience functions
 
@@ -0,0 +1,76 @@
+// ------------------------------
+// Dependencies
+
+// Local and third-party dependencies
+#include "recipe.hpp"
+
+// ------------------------------
+// Macros and aliases
+
+/**
+ * Each vector allocated from a `TempVectorStack` is rounded up to a multiple of 8 bytes
+ * and padded by 64 bytes (for SIMD loads and stores past the last element). Each vector
+ * is also bracketed by two 8-byte guard words, used to check for overruns.
+ */
+constexpr int64_t TEMPVECTOR_PADDING   = 64;
+constexpr int64_t TEMPVECTOR_GUARDSIZE = 2 * sizeof(uint64_t);
+
+
+// ------------------------------
+// Functions
+
+// >> Scratch space
+
+/** The bytes a `TempVectorStack` uses for a vector of one minibatch of `elem_size`. */
+constexpr int64_t
+MiniBatchVectorSize(int64_t elem_size) {
+    int64_t data_size = MiniBatch::kMiniBatchLength * elem_size;
+
+    return (
+          ((data_size + 7) / 8) * 8
+        + TEMPVECTOR_PADDING
+        + TEMPVECTOR_GUARDSIZE
+    );
+}
+
+/**
+ * The exact number of bytes `HashBatch` allocates from its `TempVectorStack`.
+ *
+ * `HashMultiColumn` allocates all of its scratch vectors up front, each holding one
+ * minibatch (`MiniBatch::kMiniBatchLength` rows), whatever the number of rows. It then
+ * hashes every key column one minibatch at a time, combining into those same vectors:
+ *  - `Hashing32`: uint32 hashes of one column, uint16 indices of null rows and uint32
+ *    hashes of null rows
+ *  - `Hashing64`: uint16 indices of null rows and uint64 hashes of null rows (each
+ *    column's hashes are combined into the output directly)
+ *
+ * So the size depends on neither the number of key columns, nor their types (fixed-width,
+ * boolean or variable-width), nor the length of their values: for a minibatch, it's 10480
+ * bytes for 32-bit hashes and 10400 bytes for 64-bit hashes.
+ */
+int64_t
+HashStackSize(int hash_bits) {
+    if (hash_bits == 64) {
+        return MiniBatchVectorSize(sizeof(uint16_t)) + MiniBatchVectorSize(sizeof(uint64_t));
+    }
+
+    return (
+          MiniBatchVectorSize(sizeof(uint32_t))
+        + MiniBatchVectorSize(sizeof(uint16_t))
+        + MiniBatchVectorSize(sizeof(uint32_t))
+    );
+}
+
+
+// ------------------------------
+// Classes
+
+Status
+GrowableTempStack::Reserve(int64_t stack_size) {
+    if (stack_size <= stack_capacity) { return Status::OK(); }
+
+    ARROW_RETURN_NOT_OK(temp_stack.Init(stack_pool, stack_size));
+    stack_capacity = stack_size;
+
+    return Status::OK();
+}
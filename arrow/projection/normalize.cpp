@@ -0,0 +1,419 @@
+// ------------------------------
+// Dependencies
+
+// Local and third-party dependencies
+#include "recipe.hpp"
+
+#include <cmath>
+#include <arrow/util/cpu_info.h>
+
+// The AVX2 loop has its own `target` attribute; it's only called if the CPU supports it
+#if defined(__GNUC__) and defined(__x86_64__)
+    #define NORMALIZE_X86_SIMD 1
+    #include <immintrin.h>
+#else
+    #define NORMALIZE_X86_SIMD 0
+#endif
+
+
+// ------------------------------
+// Macros and aliases
+
+using arrow::ArraySpan;
+
+using arrow::compute::KernelContext;
+using arrow::compute::KernelState;
+using arrow::compute::KernelInit;
+using arrow::compute::KernelInitArgs;
+using arrow::compute::ExecSpan;
+using arrow::compute::ExecResult;
+
+using arrow::compute::ScalarFunction;
+using arrow::compute::ScalarKernel;
+using arrow::compute::FunctionDoc;
+using arrow::compute::FunctionOptionsType;
+using arrow::compute::InputType;
+using arrow::compute::OutputType;
+using arrow::compute::Arity;
+
+using arrow::compute::ScalarAggregateOptions;
+using arrow::compute::VarianceOptions;
+using arrow::compute::CallFunction;
+using arrow::compute::call;
+
+using arrow::internal::CpuInfo;
+
+
+// ------------------------------
+// Options
+
+/** The `FunctionOptionsType` shared by the options classes below. */
+template <typename OptionsType>
+class NormalizeOptionsType : public FunctionOptionsType {
+    public:
+        const char*
+        type_name() const override { return OptionsType::kTypeName; }
+
+        string
+        Stringify(const FunctionOptions &options) const override {
+            return static_cast<const OptionsType&>(options).Describe();
+        }
+
+        bool
+        Compare(const FunctionOptions &lhs, const FunctionOptions &rhs) const override {
+            return static_cast<const OptionsType&>(lhs).IsEqual(
+                static_cast<const OptionsType&>(rhs)
+            );
+        }
+
+        std::unique_ptr<FunctionOptions>
+        Copy(const FunctionOptions &options) const override {
+            return std::make_unique<OptionsType>(static_cast<const OptionsType&>(options));
+        }
+};
+
+template <typename OptionsType>
+const FunctionOptionsType*
+GetNormalizeOptionsType() {
+    static const NormalizeOptionsType<OptionsType> options_type;
+    return &options_type;
+}
+
+CpmOptions::CpmOptions(double total)
+    : FunctionOptions(GetNormalizeOptionsType<CpmOptions>()), total(total) {}
+
+string
+CpmOptions::Describe() const {
+    return "CpmOptions(total=" + std::to_string(total) + ")";
+}
+
+bool
+CpmOptions::IsEqual(const CpmOptions &other) const { return total == other.total; }
+
+ZScoreOptions::ZScoreOptions(double mean, double stddev)
+    : FunctionOptions(GetNormalizeOptionsType<ZScoreOptions>())
+     ,mean(mean)
+     ,stddev(stddev) {}
+
+string
+ZScoreOptions::Describe() const {
+    return (
+          "ZScoreOptions(mean="  + std::to_string(mean)
+        + ", stddev="            + std::to_string(stddev) + ")"
+    );
+}
+
+bool
+ZScoreOptions::IsEqual(const ZScoreOptions &other) const {
+    return mean == other.mean and stddev == other.stddev;
+}
+
+
+// ------------------------------
+// Kernels
+
+// >> Loops
+/**
+ * CPM and z-score are both `(value - shift) * scale`, with `shift` and `scale` taken from
+ * the column's statistics, so they share one loop. Null slots are computed along with
+ * valid ones (their output is masked by the validity bitmap), which keeps the loop
+ * branch-free.
+ */
+template <typename CType>
+void
+AffineLoop(const CType *in, double *out, int64_t n, double shift, double scale) {
+    for (int64_t ndx = 0; ndx < n; ++ndx) {
+        out[ndx] = (static_cast<double>(in[ndx]) - shift) * scale;
+    }
+}
+
+#if NORMALIZE_X86_SIMD
+/**
+ * The AVX2 loop for double input (the type of the expression counts). This doesn't use
+ * FMA, so that results are identical to the scalar loop.
+ */
+__attribute__((target("avx2")))
+void
+AffineLoopAvx2(const double *in, double *out, int64_t n, double shift, double scale) {
+    __m256d shift_vec = _mm256_set1_pd(shift);
+    __m256d scale_vec = _mm256_set1_pd(scale);
+
+    int64_t ndx = 0;
+    for (; ndx + 4 <= n; ndx += 4) {
+        __m256d vals = _mm256_loadu_pd(in + ndx);
+        _mm256_storeu_pd(out + ndx, _mm256_mul_pd(_mm256_sub_pd(vals, shift_vec), scale_vec));
+    }
+
+    AffineLoop(in + ndx, out + ndx, n - ndx, shift, scale);
+}
+#endif
+
+
+// >> Kernel state
+/** The `shift` and `scale` of an affine normalization, derived from its options. */
+struct AffineState : public KernelState {
+    AffineState(double shift, double scale) : shift(shift), scale(scale) {}
+
+    double shift;
+    double scale;
+};
+
+Result<std::unique_ptr<KernelState>>
+InitCpm(KernelContext*, const KernelInitArgs &args) {
+    if (args.options == nullptr) {
+        return Status::Invalid("normalize_cpm requires CpmOptions");
+    }
+
+    double total = static_cast<const CpmOptions*>(args.options)->total;
+    return std::make_unique<AffineState>(0, total == 0 ? 0 : 1e6 / total);
+}
+
+Result<std::unique_ptr<KernelState>>
+InitZScore(KernelContext*, const KernelInitArgs &args) {
+    if (args.options == nullptr) {
+        return Status::Invalid("normalize_zscore requires ZScoreOptions");
+    }
+
+    auto options = static_cast<const ZScoreOptions*>(args.options);
+    return std::make_unique<AffineState>(
+         options->mean
+        ,options->stddev == 0 ? 0 : 1 / options->stddev
+    );
+}
+
+
+// >> Kernels (registered with the default `INTERSECTION` and `PREALLOCATE`)
+template <typename CType>
+struct AffineKernel {
+    static Status
+    Exec(KernelContext *ctx, const ExecSpan &input_args, ExecResult *out) {
+        auto             state     = static_cast<const AffineState*>(ctx->state());
+        const ArraySpan &input_arr = input_args[0].array;
+        const CType     *in_vals   = input_arr.GetValues<CType>(1);
+        double          *out_vals  = out->array_span_mutable()->GetValues<double>(1);
+
+        #if NORMALIZE_X86_SIMD
+            if constexpr (std::is_same<CType, double>::value) {
+                if (ctx->exec_context()->cpu_info()->IsSupported(CpuInfo::AVX2)) {
+                    AffineLoopAvx2(in_vals, out_vals, input_arr.length, state->shift, state->scale);
+                    return Status::OK();
+                }
+            }
+        #endif
+
+        AffineLoop(in_vals, out_vals, input_arr.length, state->shift, state->scale);
+        return Status::OK();
+    }
+};
+
+/**
+ * `log1p` has no vector instruction; the standard library's `log1p` is accurate near 0,
+ * which is where most (sparse) counts are.
+ */
+template <typename CType>
+struct Log1pKernel {
+    static Status
+    Exec(KernelContext*, const ExecSpan &input_args, ExecResult *out) {
+        const ArraySpan &input_arr = input_args[0].array;
+        const CType     *in_vals   = input_arr.GetValues<CType>(1);
+        double          *out_vals  = out->array_span_mutable()->GetValues<double>(1);
+
+        for (int64_t ndx = 0; ndx < input_arr.length; ++ndx) {
+            out_vals[ndx] = std::log1p(static_cast<double>(in_vals[ndx]));
+        }
+
+        return Status::OK();
+    }
+};
+
+
+// ------------------------------
+// Functions
+
+// >> Registration as compute functions
+
+const FunctionDoc normalize_log1p_doc {
+     "Compute log(1 + x) of counts, as float64"
+    ,"Nulls are propagated. Unlike 'log1p', integer counts are accepted as they are."
+    ,{ "counts" }
+};
+
+const FunctionDoc normalize_cpm_doc {
+     "Normalize counts to counts per million of their column total"
+    ,(
+         "Each count is divided by CpmOptions::total and multiplied by 1e6, as float64.\n"
+         "The total is the sum of the whole column, so it's passed as an option (for use\n"
+         "in projections over batches); see NormalizeCpm to compute it from the input."
+     )
+    ,{ "counts" }
+    ,"CpmOptions"
+    ,/*options_required=*/true
+};
+
+const FunctionDoc normalize_zscore_doc {
+     "Normalize values to z-scores using their column's mean and standard deviation"
+    ,(
+         "Each value becomes (value - mean) / stddev, as float64, with the statistics in\n"
+         "ZScoreOptions; see ZScoreByColumn to compute them from the input."
+     )
+    ,{ "values" }
+    ,"ZScoreOptions"
+    ,/*options_required=*/true
+};
+
+template <template <typename> class KernelType, typename ArrowType>
+void
+AddNormalizeKernel(ScalarFunction *normalize_fn, KernelInit kernel_init) {
+    ARROW_CHECK_OK(
+        normalize_fn->AddKernel(
+             { InputType(ArrowType::type_id) }
+            ,OutputType(arrow::float64())
+            ,KernelType<typename ArrowType::c_type>::Exec
+            ,kernel_init
+        )
+    );
+}
+
+/** Adds a kernel for each numeric type that counts are stored as. */
+template <template <typename> class KernelType>
+void
+AddNumericKernels(ScalarFunction *normalize_fn, KernelInit kernel_init = nullptr) {
+    AddNormalizeKernel<KernelType, arrow::Int32Type >(normalize_fn, kernel_init);
+    AddNormalizeKernel<KernelType, arrow::Int64Type >(normalize_fn, kernel_init);
+    AddNormalizeKernel<KernelType, arrow::UInt32Type>(normalize_fn, kernel_init);
+    AddNormalizeKernel<KernelType, arrow::UInt64Type>(normalize_fn, kernel_init);
+    AddNormalizeKernel<KernelType, arrow::FloatType >(normalize_fn, kernel_init);
+    AddNormalizeKernel<KernelType, arrow::DoubleType>(normalize_fn, kernel_init);
+}
+
+/**
+ * Registers "normalize_log1p", "normalize_cpm" and "normalize_zscore". These are scalar
+ * functions, so they can be used in projection expressions and are applied to each batch
+ * (or chunk) as it's scanned.
+ */
+void
+RegisterNormalizeFunctions(FunctionRegistry *registry) {
+    auto fn_log1p  = std::make_shared<ScalarFunction>(
+        "normalize_log1p", Arity::Unary(), normalize_log1p_doc
+    );
+    auto fn_cpm    = std::make_shared<ScalarFunction>(
+        "normalize_cpm", Arity::Unary(), normalize_cpm_doc
+    );
+    auto fn_zscore = std::make_shared<ScalarFunction>(
+        "normalize_zscore", Arity::Unary(), normalize_zscore_doc
+    );
+
+    AddNumericKernels<Log1pKernel> (fn_log1p.get());
+    AddNumericKernels<AffineKernel>(fn_cpm.get()   , InitCpm);
+    AddNumericKernels<AffineKernel>(fn_zscore.get(), InitZScore);
+
+    ARROW_CHECK_OK(registry->AddFunction(std::move(fn_log1p)));
+    ARROW_CHECK_OK(registry->AddFunction(std::move(fn_cpm)));
+    ARROW_CHECK_OK(registry->AddFunction(std::move(fn_zscore)));
+}
+
+
+// >> Column statistics
+/** Returns a numeric scalar as a double; a null scalar (e.g. from no values) is 0. */
+Result<double>
+ScalarAsDouble(const Datum &stat_result) {
+    if (not stat_result.scalar()->is_valid) { return 0; }
+
+    ARROW_ASSIGN_OR_RAISE(auto stat_double, arrow::compute::Cast(stat_result, arrow::float64()));
+    return std::static_pointer_cast<arrow::DoubleScalar>(stat_double.scalar())->value;
+}
+
+Result<CpmOptions>
+CpmOptionsFor(const Datum &counts, ExecContext *ctx) {
+    ScalarAggregateOptions sum_options { /*skip_nulls=*/true, /*min_count=*/0 };
+    ARROW_ASSIGN_OR_RAISE(auto col_total, CallFunction("sum", { counts }, &sum_options, ctx));
+    ARROW_ASSIGN_OR_RAISE(auto total    , ScalarAsDouble(col_total));
+
+    return CpmOptions(total);
+}
+
+Result<ZScoreOptions>
+ZScoreOptionsFor(const Datum &values, ExecContext *ctx) {
+    VarianceOptions stddev_options { /*ddof=*/0 };
+    ARROW_ASSIGN_OR_RAISE(auto col_mean  , CallFunction("mean", { values }, ctx));
+    ARROW_ASSIGN_OR_RAISE(
+         auto col_stddev
+        ,CallFunction("stddev", { values }, &stddev_options, ctx)
+    );
+
+    ARROW_ASSIGN_OR_RAISE(auto mean  , ScalarAsDouble(col_mean));
+    ARROW_ASSIGN_OR_RAISE(auto stddev, ScalarAsDouble(col_stddev));
+    return ZScoreOptions(mean, stddev);
+}
+
+
+// >> Convenience functions (for an array or chunked array holding a whole column)
+Result<Datum>
+NormalizeLog1p(const Datum &counts, ExecContext *ctx) {
+    return CallFunction("normalize_log1p", { counts }, ctx);
+}
+
+Result<Datum>
+NormalizeCpm(const Datum &counts, ExecContext *ctx) {
+    ARROW_ASSIGN_OR_RAISE(auto cpm_options, CpmOptionsFor(counts, ctx));
+    return CallFunction("normalize_cpm", { counts }, &cpm_options, ctx);
+}
+
+Result<Datum>
+ZScoreByColumn(const Datum &values, ExecContext *ctx) {
+    ARROW_ASSIGN_OR_RAISE(auto zscore_options, ZScoreOptionsFor(values, ctx));
+    return CallFunction("normalize_zscore", { values }, &zscore_options, ctx);
+}
+
+
+// >> Normalization in a projection
+/**
+ * Returns one projection expression per column in `col_names`, normalizing it by `method`.
+ *
+ * CPM and z-score need statistics of each whole column, which a projection (applied to
+ * one batch at a time) can't compute. They're computed here first, from the unfiltered
+ * columns, and baked into each expression's options. The scan that uses the expressions
+ * then normalizes each batch as it's produced, rather than in passes over the result.
+ */
+Result<vector<Expression>>
+NormalizedProjection( shared_ptr<InMemoryDataset>  dataset
+                     ,const vector<string>        &col_names
+                     ,NormalizeMethod              method) {
+    shared_ptr<Table> stat_cols;
+    if (method == NormalizeMethod::Cpm or method == NormalizeMethod::ZScore) {
+        ARROW_ASSIGN_OR_RAISE(stat_cols, ProjectFromDataset(dataset, col_names, nullptr));
+    }
+
+    vector<Expression> proj_exprs;
+    proj_exprs.reserve(col_names.size());
+
+    for (const auto &col_name : col_names) {
+        Expression col_ref = field_ref(FieldRef(col_name));
+
+        switch (method) {
+            case NormalizeMethod::None:
+                proj_exprs.push_back(col_ref);
+                break;
+
+            case NormalizeMethod::Log1p:
+                proj_exprs.push_back(call("normalize_log1p", { col_ref }));
+                break;
+
+            case NormalizeMethod::Cpm: {
+                Datum col_counts { stat_cols->GetColumnByName(col_name) };
+                ARROW_ASSIGN_OR_RAISE(auto cpm_options, CpmOptionsFor(col_counts, nullptr));
+                proj_exprs.push_back(call("normalize_cpm", { col_ref }, cpm_options));
+                break;
+            }
+
+            case NormalizeMethod::ZScore: {
+                Datum col_values { stat_cols->GetColumnByName(col_name) };
+                ARROW_ASSIGN_OR_RAISE(auto zscore_options, ZScoreOptionsFor(col_values, nullptr));
+                proj_exprs.push_back(call("normalize_zscore", { col_ref }, zscore_options));
+                break;
+            }
+        }
+    }
+
+    return proj_exprs;
+}
@@ -89,13 +89,35 @@ vector<string> cluster_cells = {
 // ------------------------------
 // Functions
 
+/** Parses the optional normalization argument: "log1p", "cpm" or "zscore". */
+Result<NormalizeMethod>
+ParseNormalizeMethod(const string &method_name) {
+    if (method_name == "none"  ) { return NormalizeMethod::None;   }
+    if (method_name == "log1p" ) { return NormalizeMethod::Log1p;  }
+    if (method_name == "cpm"   ) { return NormalizeMethod::Cpm;    }
+    if (method_name == "zscore") { return NormalizeMethod::ZScore; }
+
+    return Status::Invalid("Unknown normalization: ", method_name);
+}
+
 
 int main(int argc, char **argv) {
-    if (argc != 2) {
-        std::cerr << "Usage: read-test <path-to-input-directory>" << std::endl;
+    if (argc != 2 and argc != 3) {
+        std::cerr << "Usage: read-test <path-to-input-directory> [none|log1p|cpm|zscore]"
+                  << std::endl
+        ;
+
+        return 1;
+    }
+
+    auto normalize_method = ParseNormalizeMethod(argc == 3 ? argv[2] : "none");
+    if (not normalize_method.ok()) {
+        std::cerr << normalize_method.status().message() << std::endl;
         return 1;
     }
 
+    RegisterNormalizeFunctions(arrow::compute::GetFunctionRegistry());
+
     // read the test data from a file in IPC format
     auto test_filepath  = ConstructFileUri(argv[1]);
     auto dataset_result = DatasetFromFile(test_filepath);
@@ -132,8 +154,6 @@ int main(int argc, char **argv) {
     };
     */
 
-    auto tstart = std::chrono::steady_clock::now();
-
     Expression filter_expr_sel10 = greater(field_ref(FieldRef("SRR3052220")), literal(10));
     Expression filter_expr_sel25 = or_({
          greater(field_ref(FieldRef("SRR3052220")), literal(10))
@@ -144,7 +164,43 @@ int main(int argc, char **argv) {
         ,greater(field_ref(FieldRef("SRR5290291")), literal(10))
     });
 
-    auto table_result = ProjectFromDataset(*dataset_result, cluster_cells, &filter_expr_sel25);
+    // Statistics of the filtered columns (computed once per dataset) let the scan skip
+    // batches where no count is above the threshold
+    vector<string> filter_cols;
+    for (const auto &filter_ref : arrow::compute::FieldsInExpression(filter_expr_sel25)) {
+        filter_cols.push_back(*filter_ref.name());
+    }
+
+    auto zstart   = std::chrono::steady_clock::now();
+    auto zone_map = DatasetZoneMap::Make(*dataset_result, filter_cols);
+    if (not zone_map.ok()) {
+        std::cerr << "Failed to compute zone map:"      << std::endl
+                  << "\t" << zone_map.status().message() << std::endl
+        ;
+
+        return 1;
+    }
+
+    auto zstop  = std::chrono::steady_clock::now();
+    auto tstart = std::chrono::steady_clock::now();
+
+    // Normalization (if any) is part of the projection, so it happens during the scan
+    auto proj_exprs = NormalizedProjection(*dataset_result, cluster_cells, *normalize_method);
+    if (not proj_exprs.ok()) {
+        std::cerr << "Failed to build normalized projection:" << std::endl
+                  << "\t" << proj_exprs.status().message()    << std::endl
+        ;
+
+        return 1;
+    }
+
+    auto table_result = ProjectFromDataset(
+         *dataset_result
+        ,*proj_exprs
+        ,cluster_cells
+        ,&filter_expr_sel25
+        ,zone_map->get()
+    );
     if (not table_result.ok()) {
         std::cerr << "Failed to project from dataset" << std::endl;
         return 1;
@@ -165,6 +221,7 @@ int main(int argc, char **argv) {
     std::cout << "Start Time (ms): " << TickToMS(tstart)               << std::endl;
     std::cout << "Stop  Time (ms): " << TickToMS(tstop)                << std::endl;
     std::cout << "Duration   (ms): " << CountTicks(tstart, tstop)      << std::endl;
+    std::cout << "Zone map   (ms): " << CountTicks(zstart, zstop)      << std::endl;
 
     return 0;
 }
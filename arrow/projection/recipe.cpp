@@ -82,6 +82,40 @@ ProjectFromDataset( shared_ptr<InMemoryDataset>  dataset
 }
 
 
+/**
+ * Like `ProjectFromDataset` above, but projects expressions (e.g. from `NormalizedProjection`)
+ * instead of column names. Each expression's result is named by `proj_names`.
+ *
+ * If `zone_map` (computed from `dataset`) is given, batches that can't satisfy
+ * `data_filter` are dropped before the scan.
+ */
+Result<shared_ptr<Table>>
+ProjectFromDataset( shared_ptr<InMemoryDataset>  dataset
+                   ,vector<Expression>           proj_exprs
+                   ,vector<string>               proj_names
+                   ,Expression                  *data_filter
+                   ,const DatasetZoneMap        *zone_map) {
+    if (zone_map != nullptr and data_filter != nullptr) {
+        if (not zone_map->IsFor(*dataset)) {
+            return Status::Invalid("Zone map was computed from a different dataset");
+        }
+
+        ARROW_ASSIGN_OR_RAISE(dataset, zone_map->Prune(*data_filter));
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto scanbuilder, dataset->NewScan());
+    ARROW_RETURN_NOT_OK(scanbuilder->Project(std::move(proj_exprs), std::move(proj_names)));
+
+    if (data_filter != nullptr) {
+        ARROW_RETURN_NOT_OK(scanbuilder->Filter(*data_filter));
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto batch_scanner, scanbuilder->Finish());
+
+    return batch_scanner->ToTable();
+}
+
+
 // ------------------------------
 // Convenience Functions
 
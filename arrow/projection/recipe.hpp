@@ -70,8 +70,16 @@ using arrow::ipc::MakeFileWriter;
 using arrow::compute::DictionaryEncode;
 using arrow::compute::Filter;
 
+// arrow compute function registration
+using arrow::compute::FunctionOptions;
+using arrow::compute::FunctionRegistry;
+using arrow::compute::ExecContext;
+
 // for arrow expressions
 using arrow::compute::greater;
+using arrow::compute::greater_equal;
+using arrow::compute::less_equal;
+using arrow::compute::and_;
 using arrow::compute::or_;
 using arrow::compute::literal;
 using arrow::compute::field_ref;
@@ -85,6 +93,77 @@ using arrow::compute::MakeExecNode;
 using filter_type = std::function<Result<shared_ptr<Array>>(shared_ptr<Table>)>;
 
 
+// ------------------------------
+// Classes
+
+/**
+ * Options for "normalize_cpm": each count is divided by `total` (the sum of its column)
+ * and scaled to counts per million. A `total` of 0 normalizes every count to 0.
+ */
+class CpmOptions : public FunctionOptions {
+    public:
+        explicit CpmOptions(double total);
+
+        static constexpr char kTypeName[] = "CpmOptions";
+
+        string Describe()                        const;
+        bool   IsEqual(const CpmOptions &other) const;
+
+        double total;
+};
+
+/**
+ * Options for "normalize_zscore": each value becomes `(value - mean) / stddev`, using the
+ * statistics of its column. A `stddev` of 0 (a constant column) normalizes to 0.
+ */
+class ZScoreOptions : public FunctionOptions {
+    public:
+        ZScoreOptions(double mean, double stddev);
+
+        static constexpr char kTypeName[] = "ZScoreOptions";
+
+        string Describe()                           const;
+        bool   IsEqual(const ZScoreOptions &other) const;
+
+        double mean;
+        double stddev;
+};
+
+/** How `NormalizedProjection` normalizes each projected column. */
+enum class NormalizeMethod { None, Log1p, Cpm, ZScore };
+
+/**
+ * Per-batch min, max and null count (a "zone map") of some columns of an `InMemoryDataset`.
+ * Each batch's statistics are kept as a guarantee (e.g. `SRR3052220 >= 0 and SRR3052220 <=
+ * 7`), so `Prune` can simplify a filter against it: a batch for which the filter becomes
+ * `false` (or null) can't have any matching rows, and is skipped without being scanned.
+ *
+ * NaN isn't covered by a batch's `[min, max]`, so filters that NaN would satisfy (e.g.
+ * `not(x <= 10)`) shouldn't be pruned with this.
+ */
+class DatasetZoneMap {
+    public:
+        static Result<std::unique_ptr<DatasetZoneMap>>
+        Make(shared_ptr<InMemoryDataset> dataset, const vector<string> &col_names);
+
+        /** True if this zone map was computed from `dataset`. */
+        bool
+        IsFor(const InMemoryDataset &dataset) const { return &dataset == indexed_dataset.get(); }
+
+        /** A dataset of only the batches that may have rows satisfying `data_filter`. */
+        Result<shared_ptr<InMemoryDataset>>
+        Prune(const Expression &data_filter) const;
+
+        int
+        batch_count() const { return static_cast<int>(batches.size()); }
+
+    private:
+        shared_ptr<InMemoryDataset>                           indexed_dataset;
+        vector<shared_ptr<RecordBatch>>                       batches;
+        vector<Expression>                                    batch_guarantees;
+};
+
+
 // ------------------------------
 // Functions
 
@@ -105,6 +184,32 @@ ProjectFromDataset( shared_ptr<InMemoryDataset>  dataset
                    ,vector<string>               data_attrs
                    ,Expression                  *data_filter);
 
+Result<shared_ptr<Table>>
+ProjectFromDataset( shared_ptr<InMemoryDataset>  dataset
+                   ,vector<Expression>           proj_exprs
+                   ,vector<string>               proj_names
+                   ,Expression                  *data_filter
+                   ,const DatasetZoneMap        *zone_map = nullptr);
+
+
+// normalization functions (registered compute functions and their use in projections)
+void
+RegisterNormalizeFunctions(FunctionRegistry *registry);
+
+Result<Datum>
+NormalizeLog1p(const Datum &counts, ExecContext *ctx = nullptr);
+
+Result<Datum>
+NormalizeCpm(const Datum &counts, ExecContext *ctx = nullptr);
+
+Result<Datum>
+ZScoreByColumn(const Datum &values, ExecContext *ctx = nullptr);
+
+Result<vector<Expression>>
+NormalizedProjection( shared_ptr<InMemoryDataset>  dataset
+                     ,const vector<string>        &col_names
+                     ,NormalizeMethod              method);
+
 
 // storage functions (readers and writers)
 string ConstructFileUri(char *file_dirpath);
@@ -0,0 +1,103 @@
+// ------------------------------
+// Dependencies
+
+// Local and third-party dependencies
+#include "recipe.hpp"
+
+// ------------------------------
+// Macros and aliases
+
+using arrow::StructScalar;
+using arrow::compute::ScalarAggregateOptions;
+using arrow::compute::SimplifyWithGuarantee;
+
+
+// ------------------------------
+// Functions
+
+/**
+ * What the statistics of `col_vals` guarantee about every row of its batch: that the
+ * column is null (if every value is), or that it's within `[min, max]`.
+ */
+Result<Expression>
+ColumnGuarantee(const string &col_name, const shared_ptr<Array> &col_vals) {
+    Expression col_ref = field_ref(FieldRef(col_name));
+
+    // `min_count = 1`, so a column without any (non-null) values gets a null min and max
+    ScalarAggregateOptions minmax_opts { /*skip_nulls=*/true, /*min_count=*/1 };
+    ARROW_ASSIGN_OR_RAISE(Datum minmax_result, arrow::compute::MinMax(col_vals, minmax_opts));
+
+    const auto &minmax_vals = minmax_result.scalar_as<StructScalar>().value;
+    if (not minmax_vals[0]->is_valid) { return arrow::compute::is_null(col_ref); }
+
+    return and_(
+         greater_equal(col_ref, literal(minmax_vals[0]))
+        ,less_equal   (col_ref, literal(minmax_vals[1]))
+    );
+}
+
+
+// ------------------------------
+// Classes
+
+/**
+ * Scans `dataset` once, keeping its batches (which are only referenced, not copied) and
+ * the guarantee of each batch for every column in `col_names` (e.g. the columns that
+ * filters will use).
+ */
+Result<std::unique_ptr<DatasetZoneMap>>
+DatasetZoneMap::Make(shared_ptr<InMemoryDataset> dataset, const vector<string> &col_names) {
+    std::unique_ptr<DatasetZoneMap> zone_map { new DatasetZoneMap };
+    zone_map->indexed_dataset = dataset;
+
+    ARROW_ASSIGN_OR_RAISE(auto scanbuilder  , dataset->NewScan());
+    ARROW_ASSIGN_OR_RAISE(auto batch_scanner, scanbuilder->Finish());
+    ARROW_ASSIGN_OR_RAISE(auto batch_iter   , batch_scanner->ScanBatches());
+
+    for (auto next_batch : batch_iter) {
+        ARROW_ASSIGN_OR_RAISE(auto tagged_batch, next_batch);
+        const auto &record_batch = tagged_batch.record_batch;
+
+        vector<Expression> col_guarantees;
+        col_guarantees.reserve(col_names.size());
+
+        for (const auto &col_name : col_names) {
+            auto col_vals = record_batch->GetColumnByName(col_name);
+            if (col_vals == nullptr) {
+                return Status::Invalid("Dataset has no column: ", col_name);
+            }
+
+            ARROW_ASSIGN_OR_RAISE(auto col_guarantee, ColumnGuarantee(col_name, col_vals));
+            col_guarantees.push_back(std::move(col_guarantee));
+        }
+
+        // Bind once here, rather than for every filter
+        ARROW_ASSIGN_OR_RAISE(
+             auto batch_guarantee
+            ,and_(std::move(col_guarantees)).Bind(*dataset->schema())
+        );
+
+        zone_map->batches.push_back(record_batch);
+        zone_map->batch_guarantees.push_back(std::move(batch_guarantee));
+    }
+
+    return zone_map;
+}
+
+Result<shared_ptr<InMemoryDataset>>
+DatasetZoneMap::Prune(const Expression &data_filter) const {
+    const auto &data_schema = indexed_dataset->schema();
+    ARROW_ASSIGN_OR_RAISE(auto bound_filter, data_filter.Bind(*data_schema));
+
+    vector<shared_ptr<RecordBatch>> kept_batches;
+    for (size_t batch_ndx = 0; batch_ndx < batches.size(); ++batch_ndx) {
+        ARROW_ASSIGN_OR_RAISE(
+             auto batch_filter
+            ,SimplifyWithGuarantee(bound_filter, batch_guarantees[batch_ndx])
+        );
+
+        if (batch_filter.IsSatisfiable()) { kept_batches.push_back(batches[batch_ndx]); }
+    }
+
+    return std::make_shared<InMemoryDataset>(data_schema, std::move(kept_batches));
+}